@@ -0,0 +1,91 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+
+// The agents at one location and timestep of a path table with collisions, in the order of insertion.
+// The first agent is stored inline, so only the cells of collisions allocate a vector for the other agents.
+class AgentCell
+{
+public:
+    class const_iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef int value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const int* pointer;
+        typedef int reference;
+
+        const_iterator(const AgentCell* cell, size_t i) : cell(cell), i(i) {}
+        int operator*() const { return (*cell)[i]; }
+        const_iterator& operator++() { i++; return *this; }
+        const_iterator operator++(int) { return const_iterator(cell, i++); }
+        bool operator==(const const_iterator& other) const { return i == other.i; }
+        bool operator!=(const const_iterator& other) const { return i != other.i; }
+    private:
+        const AgentCell* cell;
+        size_t i;
+    };
+
+    AgentCell() = default;
+    AgentCell(const AgentCell& other) : first(other.first),
+        others(other.others == nullptr ? nullptr : new std::vector<int>(*other.others)) {}
+    AgentCell(AgentCell&& other) noexcept = default;
+    AgentCell& operator=(AgentCell other) noexcept
+    {
+        first = other.first;
+        others.swap(other.others);
+        return *this;
+    }
+
+    bool empty() const { return first < 0; }
+    size_t size() const { return first < 0 ? 0 : 1 + (others == nullptr ? 0 : others->size()); }
+    int front() const { return first; }
+    int operator[](size_t i) const { return i == 0 ? first : (*others)[i - 1]; }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+    bool contains(int agent) const
+    {
+        return first == agent or (others != nullptr and std::find(others->begin(), others->end(), agent) != others->end());
+    }
+
+    void push_back(int agent)
+    {
+        if (first < 0)
+            first = agent;
+        else
+        {
+            if (others == nullptr)
+                others.reset(new std::vector<int>());
+            others->push_back(agent);
+        }
+    }
+    void remove(int agent)
+    {
+        if (first == agent)
+        {
+            if (others == nullptr)
+            {
+                first = -1;
+                return;
+            }
+            first = others->front();
+            others->erase(others->begin());
+        }
+        else if (others != nullptr)
+        {
+            auto it = std::find(others->begin(), others->end(), agent);
+            if (it != others->end())
+                others->erase(it);
+        }
+        if (others != nullptr and others->empty()) // back to a single agent
+            others.reset();
+    }
+
+private:
+    int first = -1; // agent ids are non-negative
+    std::unique_ptr<std::vector<int>> others;
+};
@@ -2,6 +2,7 @@
 #include "common.h"
 #include "SpaceTimeAStar.h"
 #include "SIPP.h"
+#include "CompressedPath.h"
 
 struct Agent
 {
@@ -31,7 +32,7 @@ struct Neighbor
     int old_sum_of_costs;
     set<pair<int, int>> colliding_pairs;  // id1 < id2
     set<pair<int, int>> old_colliding_pairs;  // id1 < id2
-    vector<Path> old_paths;
+    vector<CompressedPath> old_paths; // run-length encoded, as the agents may wait for a long time
 };
 
 class BasicLNS
@@ -136,6 +136,12 @@ protected:
     
 
 	vector<Path> paths_found_initially;  // contain initial paths found
+	// paths points at these decompressed copies of the run-length encoded paths of the CT nodes:
+	// current_paths[i] is decompressed from current_sources[i] of an ancestor of the node that updatePaths was
+	// called with, and generated_paths holds the new paths of the children being generated until the next call
+	vector<Path> current_paths;
+	vector<const CompressedPath*> current_sources;
+	list<Path> generated_paths;
 	// vector<MDD*> mdds_initially;  // contain initial paths found
 	vector < SingleAgentSolver* > search_engines;  // used to find (single) agents' paths and mdd
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "common.h"
 #include "Conflict.h"
+#include "CompressedPath.h"
 
 enum node_selection { NODE_RANDOM, NODE_H, NODE_DEPTH, NODE_CONFLICTS, NODE_CONFLICTPAIRS, NODE_MVC };
 
@@ -163,7 +164,7 @@ public:
 	pairing_heap< CBSNode*, compare<CBSNode::compare_node_by_d> >::handle_type focal_handle;
 
 	CBSNode* parent;
-	list< pair< int, Path> > paths; // new paths
+	list< pair< int, CompressedPath> > paths; // new paths, which CBS::updatePaths decompresses
 	inline int getFHatVal() const override { return g_val + cost_to_go; }
 	inline int getNumNewPaths() const override { return (int) paths.size(); }
 	inline string getName() const override { return "CBS Node"; }
@@ -1,5 +1,6 @@
 #pragma once
 #include "SingleAgentSolver.h"
+#include "CompressedPath.h"
 
 typedef tuple<int, int, bool> CollidingPair; // <a1, a2, internal conflict or not>
 
@@ -12,7 +13,7 @@ struct PBSNode
     //int colliding_pairs = 0;
     PBSNode* parent = nullptr;
     pair<int, int> priority; // the former has lower priority than the latter task
-    list<pair<int, Path>> new_paths;
+    list<pair<int, CompressedPath>> new_paths; // which PBS::update decompresses
     list<CollidingPair> conflicts;
     CollidingPair chosen_conflict;
     list<CollidingPair> abandoned_conflicts;
@@ -82,6 +83,11 @@ private:
     vector<list<int>> higher_external_agents; // external agents that have higher priorities
     vector<list<int>> lower_external_agents; // external agents that have lower priorities
     vector<const Path*> initial_paths;
+    // paths points at these decompressed copies of the run-length encoded paths of the nodes:
+    // current_paths[i] is decompressed from current_sources[i] of the node that update was called with or
+    // of one of its ancestors, or is the path that planPath has just found for the node being generated
+    vector<Path> current_paths;
+    vector<const CompressedPath*> current_sources;
     inline void pushNode(PBSNode* node);
     inline bool terminate();
     void topologicalSort(list<int>& ordered_agents);
@@ -0,0 +1,100 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include "common.h"
+
+
+// Copy of a path that is run-length encoded, one (location, end timestep) pair per wait run, when that is
+// smaller than one location per timestep, i.e., when the agent waits for more than half of its timesteps.
+// Random access by timestep bisects the runs; the iterators visit the location of every timestep.
+class CompressedPath
+{
+public:
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef int value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const int* pointer;
+        typedef const int& reference;
+
+        const_iterator() = default;
+        const_iterator(const CompressedPath* path, size_t run, int t) : path(path), run(run), t(t) {}
+        reference operator*() const { return path->runs.empty() ? path->locations[t] : path->runs[run].location; }
+        pointer operator->() const { return &**this; }
+        const_iterator& operator++()
+        {
+            t++;
+            if (!path->runs.empty() and t == path->runs[run].t_max)
+                run++;
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+        bool operator==(const const_iterator& other) const { return t == other.t; }
+        bool operator!=(const const_iterator& other) const { return t != other.t; }
+    private:
+        const CompressedPath* path = nullptr;
+        size_t run = 0;
+        int t = 0;
+    };
+
+    CompressedPath() = default;
+    explicit CompressedPath(const Path& path)
+    {
+        size_t num_of_runs = 0;
+        for (int t = 0; t < (int) path.size(); t++)
+        {
+            if (t == 0 or path[t].location != path[t - 1].location)
+                num_of_runs++;
+        }
+        if (num_of_runs * sizeof(Run) >= path.size() * sizeof(int))
+        {
+            locations.reserve(path.size());
+            for (const auto& entry : path)
+                locations.push_back(entry.location);
+            return;
+        }
+        runs.reserve(num_of_runs);
+        for (int t = 0; t < (int) path.size(); t++)
+        {
+            if (runs.empty() or runs.back().location != path[t].location)
+                runs.push_back(Run{path[t].location, t + 1});
+            else
+                runs.back().t_max = t + 1;
+        }
+    }
+    void decompress(Path& path) const // reuses the storage of path
+    {
+        path.resize(size());
+        std::transform(begin(), end(), path.begin(), [](int location) { return PathEntry(location); });
+    }
+
+    bool empty() const { return size() == 0; }
+    int size() const { return runs.empty() ? (int) locations.size() : runs.back().t_max; } // the number of timesteps
+    int operator[](int t) const // the location at timestep t
+    {
+        if (runs.empty())
+            return locations[t];
+        auto it = std::upper_bound(runs.begin(), runs.end(), t, [](int t, const Run& run) { return t < run.t_max; });
+        return it->location;
+    }
+    int back() const { return runs.empty() ? locations.back() : runs.back().location; }
+    const_iterator begin() const { return const_iterator(this, 0, 0); }
+    const_iterator end() const { return const_iterator(this, runs.size(), size()); }
+    size_t getMemory() const { return runs.capacity() * sizeof(Run) + locations.capacity() * sizeof(int); } // in bytes
+
+private:
+    struct Run
+    {
+        int location;
+        int t_max; // the run ends before this timestep
+    };
+    vector<Run> runs; // empty if the path is not run-length encoded
+    vector<int> locations; // the location of every timestep otherwise
+};
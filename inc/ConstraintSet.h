@@ -0,0 +1,88 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+
+// Time ranges [t_min, t_max) of vertex and edge constraints, keyed by a location or an edge index.
+// The ranges are stored in one vector sorted by key, which is scanned linearly while it is small and
+// searched by bisection afterwards. Inserting appends to the vector in O(1), and the first lookup after
+// inserting sorts the appended entries and merges them in, so building a table of n constraints, e.g., from
+// the paths of the higher-priority agents in PBS, takes O(n log n). Copies share the vector until one of
+// them inserts (copy-on-write), so copying, e.g., the initial constraints of an agent for every low-level
+// search is O(1).
+class ConstraintSet
+{
+public:
+    bool empty() const { return storage == nullptr or storage->entries.empty(); }
+    size_t size() const { return storage == nullptr ? 0 : storage->entries.size(); }
+    void clear() { storage.reset(); }
+
+    void insert(size_t key, int t_min, int t_max)
+    {
+        if (storage == nullptr)
+            storage = std::make_shared<Storage>();
+        else if (storage.use_count() > 1) // shared with other copies
+            storage = std::make_shared<Storage>(*storage);
+        storage->entries.push_back(Entry{key, t_min, t_max});
+    }
+    // calls visitor(t_min, t_max) for the ranges of key, in the order of insertion
+    template <class Visitor>
+    void visit(size_t key, Visitor visitor) const
+    {
+        if (storage == nullptr)
+            return;
+        for (auto it = find(key); it != storage->entries.end() and it->key == key; ++it)
+            visitor(it->t_min, it->t_max);
+    }
+    bool contains(size_t key, int t) const
+    {
+        if (storage == nullptr)
+            return false;
+        for (auto it = find(key); it != storage->entries.end() and it->key == key; ++it)
+        {
+            if (it->t_min <= t and t < it->t_max)
+                return true;
+        }
+        return false;
+    }
+
+private:
+    struct Entry
+    {
+        size_t key;
+        int t_min;
+        int t_max;
+    };
+    struct Storage
+    {
+        std::vector<Entry> entries;
+        size_t num_sorted = 0; // entries[0, num_sorted) are sorted by key, and the others are appended since
+    };
+    static const size_t SMALL_SIZE = 16; // up to which a linear scan is faster than bisection
+    // sorting does not change the set, so it is done on lookup even if the storage is shared
+    std::shared_ptr<Storage> storage;
+
+    // the first entry of key, or where it would be
+    std::vector<Entry>::const_iterator find(size_t key) const
+    {
+        auto& entries = storage->entries;
+        if (storage->num_sorted < entries.size())
+        { // both sorts are stable, so the ranges of each key stay in the order of insertion
+            auto by_key = [](const Entry& a, const Entry& b) { return a.key < b.key; };
+            auto middle = entries.begin() + storage->num_sorted;
+            std::stable_sort(middle, entries.end(), by_key);
+            std::inplace_merge(entries.begin(), middle, entries.end(), by_key);
+            storage->num_sorted = entries.size();
+        }
+        if (entries.size() <= SMALL_SIZE)
+        {
+            auto it = entries.cbegin();
+            while (it != entries.cend() and it->key < key)
+                ++it;
+            return it;
+        }
+        return std::lower_bound(entries.cbegin(), entries.cend(), key,
+                                [](const Entry& entry, size_t k) { return entry.key < k; });
+    }
+};
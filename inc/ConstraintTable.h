@@ -2,6 +2,7 @@
 #include "common.h"
 #include "CBSNode.h"
 #include "PathTable.h"
+#include "ConstraintSet.h"
 
 class ConstraintTable
 {
@@ -51,11 +52,10 @@ public:
 
 protected:
     friend class ReservationTable;
-    typedef unordered_map<size_t, list< pair<int, int> > > CT; // constraint table
-	CT ct; // location -> time range, or edge -> time range
+	ConstraintSet ct; // location -> time range, or edge -> time range
 	int ct_max_timestep = 0;
     // typedef unordered_map<size_t, set< pair<int, int> > > CAT; // conflict avoidance table // location -> time range, or edge -> time range
-    typedef vector< vector<bool> > CAT;
+    typedef vector<TimeBitset> CAT; // location -> timesteps
     CAT cat;
 	int cat_max_timestep = 0;
 	vector<int> cat_goals;
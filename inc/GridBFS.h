@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+
+// Unit-cost breadth-first search on a 4-neighbor grid.
+// The free cells are stored as a bitset (64 cells per word, one row after another),
+// and each BFS level expands the whole frontier with word-wide shifts and masks
+// instead of visiting the cells one by one.
+class GridBFS
+{
+public:
+    GridBFS() = default;
+    // obstacles[row * num_of_cols + col] is true if the cell is blocked
+    GridBFS(int num_of_rows, int num_of_cols, const std::vector<bool>& obstacles);
+
+    // distances[loc] = number of moves between source and loc, or unreachable if there is no path
+    void getDistances(int source, std::vector<int>& distances, int unreachable) const;
+    bool isConnected(int start, int goal) const;
+    void setBlocked(int loc, bool blocked) // updates one cell, e.g., while obstacles are added to a map
+    {
+        if (blocked)
+            free_cells[getWordIndex(loc)] &= ~getBit(loc);
+        else
+            free_cells[getWordIndex(loc)] |= getBit(loc);
+    }
+
+private:
+    int num_of_rows = 0;
+    int num_of_cols = 0;
+    int stride = 0; // words per row, including an empty word on each side
+    std::vector<uint64_t> free_cells; // num_of_rows + 2 rows, including an empty row on each side
+
+    inline int getWordIndex(int loc) const { return (loc / num_of_cols + 1) * stride + (loc % num_of_cols) / 64 + 1; }
+    inline uint64_t getBit(int loc) const { return (uint64_t) 1 << ((loc % num_of_cols) % 64); }
+
+    // calls visit(level, word_index, new_cells) for every word that gains cells at a level,
+    // and stops early once visit returns true
+    template <class Visitor>
+    void search(int source, Visitor visit) const;
+};
@@ -0,0 +1,225 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <queue>
+#include "Instance.h"
+
+
+// shortest-path distances between a few landmark locations and every location
+struct Landmarks
+{
+    vector<int> locations;
+    vector<vector<int>> distances; // distances[i][loc] is the distance between landmark i and loc
+};
+
+
+// Exact distances to one goal location, stored with 32 or 16 bits per location, or with
+// 2-bit deltas between consecutive locations (neighbors differ by at most 1) plus an absolute
+// checkpoint every 32 locations and a list of the rare larger jumps.
+// In DELTA2 mode, the values of blocked locations are not kept.
+class DistanceTable
+{
+public:
+    enum width_type { INT32, UINT16, DELTA2 };
+
+    DistanceTable(const vector<int>& distances, const Instance& instance, width_type width);
+    // INT32 table that uses the distances in place, e.g., in a memory-mapped bundle kept alive by owner
+    DistanceTable(const int* distances, int size, shared_ptr<const void> owner) :
+        width(INT32), size(size), values32_data(distances), owner(std::move(owner)) {}
+    // values32_data may point into values32, so a table is only moved, and the move points it to the moved vector
+    DistanceTable(const DistanceTable&) = delete;
+    DistanceTable& operator=(const DistanceTable&) = delete;
+    DistanceTable(DistanceTable&& other) noexcept { *this = std::move(other); }
+    DistanceTable& operator=(DistanceTable&& other) noexcept
+    {
+        width = other.width;
+        size = other.size;
+        values32 = std::move(other.values32);
+        values32_data = other.owner != nullptr ? other.values32_data : values32.data();
+        owner = std::move(other.owner);
+        values16 = std::move(other.values16);
+        codes = std::move(other.codes);
+        checkpoints = std::move(other.checkpoints);
+        jumps = std::move(other.jumps);
+        other.values32_data = nullptr;
+        return *this;
+    }
+
+    inline int operator[](int loc) const
+    {
+        switch (width)
+        {
+            case INT32:
+                return values32_data[loc];
+            case UINT16:
+                return values16[loc] == UINT16_MAX ? MAX_TIMESTEP : values16[loc];
+            default:
+                return getDelta2Value(loc);
+        }
+    }
+    vector<int> decode(const vector<bool>& obstacles) const; // with MAX_TIMESTEP for the blocked locations
+    width_type getWidth() const { return width; }
+    size_t getMemory() const; // in bytes
+private:
+    width_type width;
+    int size;
+    vector<int> values32;
+    const int* values32_data = nullptr; // values32.data(), or distances owned by owner
+    shared_ptr<const void> owner;
+    vector<uint16_t> values16;
+
+    // DELTA2 mode: code of each location (0: same value as the previous location, 1: +1, 2: -1, 3: jump)
+    vector<uint64_t> codes;
+    vector<int> checkpoints; // value of the first location of each word of codes
+    vector<pair<int, int>> jumps; // <location, value> of the locations with code 3, sorted
+
+    static const uint64_t LOW_BITS = 0x5555555555555555ULL;
+
+    inline int getDelta2Value(int loc) const
+    {
+        int word = loc / 32, pos = loc % 32;
+        if (pos == 0)
+            return checkpoints[word];
+        // codes of the locations 1..pos of the word
+        uint64_t bits = codes[word] & (pos == 31 ? ~0ULL : (1ULL << (2 * pos + 2)) - 1) & ~3ULL;
+        int value = checkpoints[word];
+        uint64_t jump_bits = bits & (bits >> 1) & LOW_BITS;
+        if (jump_bits != 0)
+        {
+            int last_jump = (63 - __builtin_clzll(jump_bits)) / 2;
+            value = std::lower_bound(jumps.begin(), jumps.end(), make_pair(word * 32 + last_jump, INT_MIN))->second;
+            bits = last_jump == 31 ? 0 : bits & ~((1ULL << (2 * last_jump + 2)) - 1);
+        }
+        int plus = __builtin_popcountll(bits & ~(bits >> 1) & LOW_BITS);
+        int minus = __builtin_popcountll((bits >> 1) & ~bits & LOW_BITS);
+        return value + plus - minus;
+    }
+};
+
+
+// Reverse resumable A* (RRA*): a backward A* search from the goal location towards the
+// start location that is only resumed when a location that it has not expanded yet is
+// looked up. Expanded locations have exact distances, as the Manhattan distance is consistent.
+class LazyHeuristic
+{
+public:
+    LazyHeuristic(const Instance& instance, int goal_location, int start_location);
+    int get(int loc);
+    size_t getNumExpanded() const { return num_expanded; }
+private:
+    struct Entry
+    {
+        int g_val;
+        bool closed;
+    };
+    typedef tuple<int, int, int> OpenEntry; // <f-val, g-val, location>
+
+    const Instance& instance;
+    int start_location;
+    unordered_map<int, Entry> entries; // generated locations
+    std::priority_queue<OpenEntry, vector<OpenEntry>, std::greater<OpenEntry>> open_list;
+    size_t num_expanded = 0;
+};
+
+
+// read-only heuristic from every location to one goal location: the exact shortest-path
+// distances, the same distances computed on demand by RRA*, or (to save memory) the ALT
+// bound derived from shared landmarks
+class HeuristicTable
+{
+public:
+    HeuristicTable() = default;
+    explicit HeuristicTable(shared_ptr<const DistanceTable> table) : table(std::move(table)) {}
+    explicit HeuristicTable(shared_ptr<LazyHeuristic> lazy) : lazy(std::move(lazy)) {}
+    HeuristicTable(const Instance& instance, shared_ptr<const Landmarks> landmarks, int goal_location);
+
+    inline int operator[](int loc) const
+    {
+        if (table != nullptr)
+            return (*table)[loc];
+        if (lazy != nullptr)
+            return lazy->get(loc);
+        int h = instance->getManhattanDistance(loc, goal_location);
+        for (size_t i = 0; i < goal_distances.size(); i++)
+            h = max(h, abs(landmarks->distances[i][loc] - goal_distances[i]));
+        return h;
+    }
+    // admissible heuristic between two arbitrary locations
+    inline int getDifferentialHeuristic(int from, int to) const
+    {
+        if (table != nullptr || lazy != nullptr)
+            return abs((*this)[from] - (*this)[to]);
+        int h = 0;
+        for (const auto& distances : landmarks->distances)
+            h = max(h, abs(distances[from] - distances[to]));
+        return h;
+    }
+    bool isExact() const { return table != nullptr || lazy != nullptr; }
+    bool isTable() const { return table != nullptr; } // exact distances that cost nothing to query
+private:
+    shared_ptr<const DistanceTable> table; // exact distances, or nullptr in the other modes
+    shared_ptr<LazyHeuristic> lazy; // RRA* mode
+
+    // landmark mode
+    const Instance* instance = nullptr;
+    shared_ptr<const Landmarks> landmarks;
+    int goal_location = -1;
+    vector<int> goal_distances; // distances between the landmarks and the goal location
+};
+
+
+// Process-wide store of goal heuristic tables keyed by (map hash, goal location),
+// so that agents (and CBS/ECBS search engines) with the same goal share one table.
+// Optionally backed by a cache file next to the map, so that repeated runs on the
+// same map skip the preprocessing.
+class HeuristicStore
+{
+public:
+    static HeuristicTable get(const Instance& instance, int goal_location);
+    // compute the missing tables of the given goal locations with num_of_threads worker threads
+    static void precompute(const Instance& instance, const vector<int>& goal_locations, int num_of_threads);
+
+    // use the heuristic tables stored in the bundle of the instance (if any) in place
+    static void useBundledHeuristics(const Instance& instance);
+
+    // load the tables of the cache file of the map (if any), and remember the file for saveCacheFile
+    static void useCacheFile(const Instance& instance);
+    // write the cache file if tables have been computed since it was loaded
+    static void saveCacheFile();
+
+    // With landmarks > 0, solvers start with the ALT heuristic of that many shared landmarks,
+    // and switch to the exact table after hot_searches searches
+    static void setLandmarks(int num_of_landmarks, int hot_searches);
+    static int getNumOfLandmarks() { return num_of_landmarks; }
+    static int getHotSearches() { return hot_searches; }
+    static HeuristicTable getLandmarkHeuristic(const Instance& instance, int goal_location);
+
+    // With lazy, solvers compute their exact heuristic on demand by RRA* instead of looking up full tables
+    static void setLazy(bool lazy) { HeuristicStore::lazy = lazy; }
+    static bool isLazy() { return lazy; }
+    static HeuristicTable getLazyHeuristic(const Instance& instance, int goal_location, int start_location);
+
+    // storage of the exact tables computed from now on
+    static void setWidth(DistanceTable::width_type width) { HeuristicStore::width = width; }
+
+    static size_t getNumTables() { return tables.size(); }
+    static size_t getMemory(); // of the exact tables, in bytes
+private:
+    typedef pair<uint64_t, int> Key; // <map hash, goal location>
+    static std::map<Key, shared_ptr<const DistanceTable>> tables;
+    static DistanceTable::width_type width;
+
+    static string cache_fname;
+    static uint64_t cache_map_hash;
+    static int cache_map_size;
+    static vector<bool> cache_obstacles; // of the map, as DELTA2 tables do not keep their distances
+    static bool dirty; // has new tables that are not in the cache file yet
+
+    static bool lazy;
+    static int num_of_landmarks;
+    static int hot_searches;
+    static std::map<uint64_t, shared_ptr<const Landmarks>> landmarks; // keyed by map hash
+
+    static shared_ptr<const Landmarks> computeLandmarks(const Instance& instance);
+    static shared_ptr<const DistanceTable> computeHeuristics(const Instance& instance, int goal_location);
+};
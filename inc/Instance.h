@@ -1,5 +1,25 @@
 #pragma once
 #include"common.h"
+#include "GridBFS.h"
+
+class MappedFile;
+
+
+// read-only range of locations stored consecutively in a table of Instance
+class LocationSpan
+{
+public:
+    LocationSpan(const int* first, const int* last) : first(first), last(last) {}
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    int front() const { return *first; }
+    int back() const { return *(last - 1); }
+private:
+    const int* first;
+    const int* last;
+};
 
 
 // Currently only works for undirected unweighted 4-nighbor grids
@@ -15,10 +35,14 @@ public:
 	Instance()=default;
 	Instance(const string& map_fname, const string& agent_fname, 
 		int num_of_agents = 0, int num_of_rows = 0, int num_of_cols = 0, int num_of_obstacles = 0, int warehouse_width = 0);
+	// load the first num_of_agents agents (0 for all) of a binary bundle written by saveBundle
+	Instance(const string& bundle_fname, int num_of_agents);
+	Instance(const Instance&) = delete; // the neighbor table may point into own vectors
 
 
 	void printAgents() const;
 	string getMapFile() const {return map_fname;};
+	uint64_t getMapHash() const {return map_hash;}; // fingerprint of the grid, used to key cached heuristics
     vector<int> getStarts() const {return start_locations;};
     vector<int> getGoals() const {return goal_locations;};
 
@@ -32,7 +56,19 @@ public:
             return false;
         return getManhattanDistance(curr, next) < 2;
     }
-    list<int> getNeighbors(int curr) const;
+    // neighbors of curr, without allocation
+    inline LocationSpan getNeighbors(int curr) const
+    {
+        return LocationSpan(neighbor_table_data + neighbor_offsets_data[curr],
+                            neighbor_table_data + neighbor_offsets_data[curr + 1] - 1);
+    }
+    // neighbors of curr followed by curr itself, i.e., the locations after a move or a wait
+    inline LocationSpan getNextLocations(int curr) const
+    {
+        return LocationSpan(neighbor_table_data + neighbor_offsets_data[curr],
+                            neighbor_table_data + neighbor_offsets_data[curr + 1]);
+    }
+    const GridBFS& getGridBFS() const { return grid_bfs; } // unit-cost BFS over the free cells
 
 
     inline int linearizeCoordinate(int row, int col) const { return ( this->num_of_cols * row + col); }
@@ -73,12 +109,30 @@ public:
 	int getDefaultNumberOfAgents() const { return num_of_agents; }
 	string getInstanceName() const { return agent_fname; }
     void savePaths(const string & file_name, const vector<Path*>& paths) const;
+
+    // write the map, the neighbor table, the agents and optionally the heuristic tables of all goal
+    // locations into a binary bundle that the bundle constructor maps into memory
+    bool saveBundle(const string& bundle_fname, bool with_heuristics) const;
+    // <goal location, distances to it> stored in the loaded bundle
+    const vector<pair<int, const int*>>& getBundledHeuristics() const { return bundled_heuristics; }
+    shared_ptr<const MappedFile> getBundle() const { return bundle; }
     bool validateSolution(const vector<Path*>& paths, int sum_of_costs, int num_of_colliding_pairs) const;
 private:
 	  // int moves_offset[MOVE_COUNT];
 	  vector<bool> my_map;
 	  string map_fname;
 	  string agent_fname;
+	  uint64_t map_hash = 0;
+	  GridBFS grid_bfs;
+	  // CSR table of next locations: the neighbors of loc and then loc itself are stored in
+	  // neighbor_table[neighbor_offsets[loc] .. neighbor_offsets[loc + 1])
+	  vector<int> neighbor_offsets;
+	  vector<int> neighbor_table;
+	  const int* neighbor_offsets_data = nullptr; // point into the vectors above, or into the bundle
+	  const int* neighbor_table_data = nullptr;
+
+	  shared_ptr<const MappedFile> bundle;
+	  vector<pair<int, const int*>> bundled_heuristics;
 
 	  int num_of_agents;
 	  vector<int> start_locations;
@@ -88,6 +142,9 @@ private:
 	  bool loadMap();
 	  void printMap() const;
 	  void saveMap() const;
+	  void computeMapHash();
+	  void buildNeighborTable();
+	  bool loadBundle(const string& bundle_fname);
 
 	  bool loadAgents();
 	  void saveAgents() const;
@@ -3,7 +3,7 @@
 #include "InitLNS.h"
 
 //pibt related
-#include "simplegrid.h"
+#include "instancegrid.h"
 #include "pibt_agent.h"
 #include "problem.h"
 #include "mapf.h"
@@ -31,10 +31,11 @@ public:
     LNS(const Instance& instance, double time_limit,
         const string & init_algo_name, const string & replan_algo_name, const string & destory_name,
         int neighbor_size, int num_of_iterations, bool init_lns, const string & init_destory_name, bool use_sipp,
-        int screen, PIBTPPS_option pipp_option);
+        int screen, PIBTPPS_option pipp_option, int num_of_threads = 1);
     ~LNS()
     {
         delete init_lns;
+        delete pibt_graph;
     }
     bool getInitialSolution();
     bool run();
@@ -52,6 +53,7 @@ private:
     int num_of_iterations;
     string init_destory_name;
     PIBTPPS_option pipp_option;
+    InstanceGrid* pibt_graph = nullptr; // built on the first PIBT/winPIBT/PPS call and reused afterwards
 
 
     PathTable path_table; // 1. stores the paths of all agents in a time-space table;
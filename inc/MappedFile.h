@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+
+// read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& fname);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return data != nullptr; }
+    const char* getData() const { return data; }
+    size_t getSize() const { return size; }
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+
+// Storage for the nodes of one low-level search at a time.
+// Nodes are constructed one after another in blocks of BLOCK_SIZE nodes, and they are
+// all released together by reset(), which only rewinds to the first slot: the blocks are
+// kept and their slots are recycled by the next search, without going back to malloc.
+template <class Node, size_t BLOCK_SIZE = 4096>
+class NodeArena
+{
+    static_assert(std::is_trivially_destructible<Node>::value, "reset() does not call destructors");
+public:
+    template <class... Args>
+    inline Node* create(Args&&... args)
+    {
+        size_t block = num_used / BLOCK_SIZE;
+        if (block == blocks.size())
+            blocks.emplace_back(new Slot[BLOCK_SIZE]);
+        if (num_used < num_touched)
+            num_recycled++;
+        else
+            num_touched++;
+        return new (&blocks[block][num_used++ % BLOCK_SIZE]) Node(std::forward<Args>(args)...);
+    }
+    // gives the slot back if node is the last one created (e.g., a duplicate that is not
+    // inserted); other nodes stay in the arena until reset()
+    inline void release(const Node* node)
+    {
+        if (num_used > 0 && node == getNode(num_used - 1))
+            num_used--;
+    }
+    void reset() { num_used = 0; }
+
+    size_t getNumUsed() const { return num_used; } // nodes of the current search
+    uint64_t getNumRecycled() const { return num_recycled; } // nodes constructed in recycled slots
+    uint64_t getRecycledBytes() const { return num_recycled * sizeof(Node); }
+    size_t getMemory() const { return blocks.size() * BLOCK_SIZE * sizeof(Node); } // in bytes
+
+private:
+    typedef typename std::aligned_storage<sizeof(Node), alignof(Node)>::type Slot;
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    size_t num_used = 0;
+    size_t num_touched = 0; // slots that have held a node at least once
+    uint64_t num_recycled = 0;
+
+    inline const Node* getNode(size_t i) const
+    {
+        return reinterpret_cast<const Node*>(&blocks[i / BLOCK_SIZE][i % BLOCK_SIZE]);
+    }
+};
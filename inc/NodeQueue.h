@@ -0,0 +1,211 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <boost/heap/pairing_heap.hpp>
+
+
+// where a node is stored in a bucket queue: its key when it was pushed, and its index in that bucket
+template <int LEVELS>
+struct BucketHandle
+{
+    std::array<int, LEVELS> key;
+    int pos;
+};
+
+
+// Buckets indexed by the next DEPTH components of the key, one level per component.
+// The nodes of a bucket are kept in LIFO order.
+template <class Node, int DEPTH>
+struct BucketLevel
+{
+    std::vector<BucketLevel<Node, DEPTH - 1>> children;
+    size_t size = 0;
+    int min_child = 0; // the first non-empty child when size > 0
+
+    template <size_t N>
+    int push(Node* node, const std::array<int, N>& key)
+    {
+        int k = key[N - DEPTH];
+        if ((int) children.size() <= k)
+            children.resize(k + 1);
+        if (size == 0 || k < min_child)
+            min_child = k;
+        size++;
+        return children[k].push(node, key);
+    }
+    template <size_t N>
+    Node* erase(const std::array<int, N>& key, int pos) // returns the node that took position pos, if any
+    {
+        int k = key[N - DEPTH];
+        Node* moved = children[k].erase(key, pos);
+        size--;
+        if (size > 0 && k == min_child)
+        {
+            while (children[min_child].size == 0)
+                min_child++;
+        }
+        return moved;
+    }
+    Node* top() const { return children[min_child].top(); }
+    template <class Visitor>
+    void visit(Visitor& visitor) const
+    {
+        for (int k = min_child; size > 0 && k < (int) children.size(); k++)
+            children[k].visit(visitor);
+    }
+    void clear() // keeps the storage of the buckets
+    {
+        for (int k = min_child; size > 0 && k < (int) children.size(); k++)
+        {
+            if (children[k].size > 0)
+            {
+                size -= children[k].size;
+                children[k].clear();
+            }
+        }
+        size = 0;
+        min_child = 0;
+    }
+};
+
+template <class Node>
+struct BucketLevel<Node, 0>
+{
+    std::vector<Node*> nodes;
+    size_t size = 0;
+
+    template <size_t N>
+    int push(Node* node, const std::array<int, N>&)
+    {
+        nodes.push_back(node);
+        return (int) size++;
+    }
+    template <size_t N>
+    Node* erase(const std::array<int, N>&, int pos)
+    {
+        Node* moved = nullptr;
+        if (pos + 1 < (int) nodes.size())
+            moved = nodes[pos] = nodes.back();
+        nodes.pop_back();
+        size--;
+        return moved;
+    }
+    Node* top() const { return nodes.back(); }
+    template <class Visitor>
+    void visit(Visitor& visitor) const
+    {
+        for (auto node : nodes)
+            visitor(node);
+    }
+    void clear()
+    {
+        nodes.clear();
+        size = 0;
+    }
+};
+
+
+// OPEN or FOCAL list of a low-level solver: either a pairing heap ordered by Compare, or
+// buckets indexed by the small integer components of Key (e.g., f and h), which push and pop
+// in O(1) apart from skipping empty buckets. Ties are broken randomly by the heap and in LIFO order
+// by the buckets. The nodes keep their handles of both implementations in HEAP_HANDLE and BUCKET_HANDLE.
+// In bucket mode, the nodes with a key component outside [0, MAX_KEY] (e.g., of unreachable goals)
+// are kept in the heap, and top() returns the better of the two tops.
+template <class Node, class Compare, class Key, int LEVELS,
+        typename boost::heap::pairing_heap<Node*, boost::heap::compare<Compare>>::handle_type Node::* HEAP_HANDLE,
+        BucketHandle<LEVELS> Node::* BUCKET_HANDLE>
+class NodeQueue
+{
+public:
+    static const int MAX_KEY = 65535; // of the key components that have buckets
+
+    explicit NodeQueue(bool bucketed = false) : bucketed(bucketed) {}
+
+    bool empty() const { return heap.empty() && (!bucketed || buckets.size == 0); }
+    size_t size() const { return heap.size() + (bucketed ? buckets.size : 0); }
+    Node* top() const
+    {
+        if (!bucketed || buckets.size == 0)
+            return heap.top();
+        if (heap.empty() || !Compare()(buckets.top(), heap.top()))
+            return buckets.top();
+        return heap.top();
+    }
+    void pop()
+    {
+        if (bucketed)
+            erase(top());
+        else
+            heap.pop();
+    }
+    void push(Node* node)
+    {
+        if (bucketed)
+        {
+            auto& handle = node->*BUCKET_HANDLE;
+            handle.key = Key()(node);
+            if (std::all_of(handle.key.begin(), handle.key.end(), [](int k) { return 0 <= k && k <= MAX_KEY; }))
+            {
+                handle.pos = buckets.push(node, handle.key);
+                return;
+            }
+            handle.pos = -1; // in the heap
+        }
+        node->*HEAP_HANDLE = heap.push(node);
+    }
+    void erase(Node* node)
+    {
+        if (bucketed && (node->*BUCKET_HANDLE).pos >= 0)
+        {
+            const auto& handle = node->*BUCKET_HANDLE;
+            Node* moved = buckets.erase(handle.key, handle.pos);
+            if (moved != nullptr)
+                (moved->*BUCKET_HANDLE).pos = handle.pos;
+        }
+        else
+            heap.erase(node->*HEAP_HANDLE);
+    }
+    void update(Node* node) // the key of node has changed
+    {
+        if (bucketed)
+        {
+            erase(node);
+            push(node);
+        }
+        else
+            heap.update(node->*HEAP_HANDLE);
+    }
+    void increase(Node* node) // the key of node has decreased, i.e., its priority has increased
+    {
+        if (bucketed)
+            update(node);
+        else
+            heap.increase(node->*HEAP_HANDLE);
+    }
+    void clear()
+    {
+        heap.clear();
+        buckets.clear();
+    }
+
+    // calls visitor(node) for every node whose first key component is in [first, last],
+    // and possibly for others, e.g., for all nodes of the heap
+    template <class Visitor>
+    void visit(int first, int last, Visitor visitor) const
+    {
+        for (auto node : heap)
+            visitor(node);
+        if (!bucketed)
+            return;
+        first = std::max(first, buckets.min_child);
+        last = std::min(last, (int) buckets.children.size() - 1);
+        for (int k = first; k <= last; k++)
+            buckets.children[k].visit(visitor);
+    }
+
+private:
+    bool bucketed;
+    boost::heap::pairing_heap<Node*, boost::heap::compare<Compare>> heap;
+    BucketLevel<Node, LEVELS> buckets;
+};
@@ -0,0 +1,106 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+
+// Open-addressing hash table (linear probing) from the nodes of a low-level search to
+// the stored node with the same key, where Key packs the identity of a node into 64 bits.
+// The slots are stamped with the search they belong to, so clear() only starts a new stamp.
+template <class Node, class Key>
+class NodeTable
+{
+public:
+    NodeTable() : slots(1024) {}
+
+    // the stored node with the same key as node, or nullptr
+    Node* find(const Node* node) const
+    {
+        auto slot = findSlot(Key()(node));
+        return slot->stamp == stamp ? slot->node : nullptr;
+    }
+    // the stored node with the same key as node, or a nullptr to be replaced by the caller
+    Node*& operator[](const Node* node)
+    {
+        if (2 * (num_of_keys + 1) > slots.size())
+            grow();
+        uint64_t key = Key()(node);
+        auto slot = findSlot(key);
+        if (slot->stamp != stamp)
+        {
+            slot->key = key;
+            slot->node = nullptr;
+            slot->stamp = stamp;
+            num_of_keys++;
+        }
+        return slot->node;
+    }
+    void clear()
+    {
+        num_of_keys = 0;
+        if (++stamp == 0) // the stamps wrapped around
+        {
+            for (auto& slot : slots)
+                slot.stamp = 0;
+            stamp = 1;
+        }
+    }
+    template <class Visitor>
+    void visit(Visitor visitor) const
+    {
+        for (const auto& slot : slots)
+        {
+            if (slot.stamp == stamp && slot.node != nullptr)
+                visitor(slot.node);
+        }
+    }
+
+private:
+    struct Slot
+    {
+        uint64_t key = 0;
+        Node* node = nullptr;
+        uint32_t stamp = 0; // the slot is used by the current search iff stamp == NodeTable::stamp
+    };
+    std::vector<Slot> slots; // the size is a power of 2
+    uint32_t stamp = 1;
+    size_t num_of_keys = 0;
+
+    static inline uint64_t hash(uint64_t key) // finalizer of MurmurHash3
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return key;
+    }
+    // the slot of key, or the empty slot where it would be inserted
+    inline const Slot* findSlot(uint64_t key) const
+    {
+        size_t mask = slots.size() - 1;
+        for (size_t i = hash(key) & mask; ; i = (i + 1) & mask)
+        {
+            if (slots[i].stamp != stamp || slots[i].key == key)
+                return &slots[i];
+        }
+    }
+    inline Slot* findSlot(uint64_t key)
+    {
+        return const_cast<Slot*>(static_cast<const NodeTable*>(this)->findSlot(key));
+    }
+    void grow()
+    {
+        std::vector<Slot> old_slots(slots.size() * 2);
+        old_slots.swap(slots);
+        uint32_t old_stamp = stamp;
+        stamp = 1;
+        for (const auto& slot : old_slots)
+        {
+            if (slot.stamp != old_stamp)
+                continue;
+            auto new_slot = findSlot(slot.key);
+            *new_slot = slot;
+            new_slot->stamp = stamp;
+        }
+    }
+};
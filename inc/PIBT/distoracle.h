@@ -0,0 +1,70 @@
+/*
+ * distoracle.h
+ *
+ * Purpose: shortest-path distances for the PIBT-family solvers
+ */
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "graph.h"
+#include "GridBFS.h"
+
+
+// interface queried by Solver::pathDist, PIBT::allocate and PPS::SHORTEST_PATH
+class DistanceOracle {
+public:
+  static const int INF = 100000;  // returned for unreachable pairs
+
+  virtual ~DistanceOracle() {}
+
+  virtual int dist(Node* s, Node* g) = 0;
+  virtual Nodes getPath(Node* s, Node* g) = 0;  // a shortest path, s and g included
+};
+
+/*
+ * One BFS table per goal, built the first time that goal is queried.
+ * Tables are kept in LRU order and the least recently used ones are
+ * dropped once their total size exceeds the budget (the most recent
+ * table is always kept), so memory grows with the number of distinct
+ * goals instead of V^2.
+ */
+class LazyDistanceOracle : public DistanceOracle {
+private:
+  Graph* G;
+  size_t budget;  // bytes
+
+  std::vector<int> localIndex;  // node id -> position in G's node list
+  Nodes localNodes;
+  std::vector<int> fwdOffsets, fwdEdges;  // CSR of G
+  std::vector<int> revOffsets, revEdges;  // CSR of the reversed G
+  bool useGridBFS;  // undirected grid, node id = y * width + x
+  GridBFS gridBFS;
+
+  struct Table {
+    std::vector<int> d;
+    std::list<int>::iterator lruPos;
+  };
+  std::unordered_map<int, Table> tables;  // keyed by local goal index
+  std::list<int> lru;  // most recently used first
+
+  size_t tableBytes() const { return localNodes.size() * sizeof(int); }
+  const std::vector<int>& getTable(int g);
+  void bfs(int g, std::vector<int>& d);
+  void shrink();
+
+public:
+  static const size_t DEFAULT_BUDGET = (size_t)1 << 30;  // 1 GB
+
+  LazyDistanceOracle(Graph* _G, size_t _budget);
+  ~LazyDistanceOracle() {}
+
+  int dist(Node* s, Node* g);
+  Nodes getPath(Node* s, Node* g);
+
+  void setBudget(size_t _budget);
+  size_t getBudget() const { return budget; }
+  size_t getNumTables() const { return tables.size(); }
+};
@@ -68,7 +68,7 @@ protected:
 public:
   Graph();
   Graph(std::mt19937* _MT);
-  ~Graph();
+  virtual ~Graph();
 
   Node* getNode(int id);
   bool existNode(int id);
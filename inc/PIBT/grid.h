@@ -14,7 +14,7 @@ protected:
 public:
   Grid();
   Grid(std::mt19937* _MT);
-  ~Grid();
+  virtual ~Grid();
 
   int getW() { return w; }
   int getH() { return h; }
@@ -0,0 +1,33 @@
+/*
+ * instancegrid.h
+ *
+ * Purpose: grid graph built from an in-memory Instance
+ */
+
+#pragma once
+#include "grid.h"
+#include "Instance.h"
+
+/*
+ * Same graph as SimpleGrid on the instance's map file (node id = row * w + col,
+ * undirected, neighbors in the order up, left, right, down), but built from
+ * the obstacles of Instance, so the map file is not parsed again and it works
+ * for instances loaded from bundles as well. LNS builds it once and reuses it
+ * for every PIBT/winPIBT/PPS call.
+ */
+class InstanceGrid : public Grid {
+private:
+  std::vector<Node*> cells;  // location -> node, nullptr for obstacles
+
+public:
+  InstanceGrid(const Instance& instance);
+  ~InstanceGrid() override;
+
+  // O(1) version of Graph::getNode, nullptr for obstacles
+  Node* getNodeAt(int loc) { return cells[loc]; }
+
+  // forget the paths cached by previous runs, so a reused graph behaves as a new one
+  void reset();
+
+  std::string logStr();
+};
@@ -1,10 +1,10 @@
 #pragma once
 
 #include "problem.h"
+#include "distoracle.h"
 #include <vector>
 #include <algorithm>
 #include <chrono>
-#include <eigen3/Eigen/Core>
 #include <unordered_map>
 #include <unordered_set>
 #include <boost/heap/fibonacci_heap.hpp>
@@ -24,7 +24,9 @@ protected:
   PIBT_Agents A;
   Graph* G;
 
-  Eigen::MatrixXi dists;
+  DistanceOracle* D;  // shortest-path distances, owned by the solver
+
+  DistanceOracle* getDistanceOracle();  // the default oracle is built the first time it is needed
 
   void init();
   int getMaxLengthPaths(Paths& paths);
@@ -46,7 +48,7 @@ public:
   Solver(Problem* _P, std::mt19937* _MT);
   ~Solver();
 
-  void WarshallFloyd();
+  void setDistanceOracle(DistanceOracle* _D);  // takes ownership
   void setTimeLimit(double limit){this->time_limit=limit;};
 
 
@@ -1,15 +1,68 @@
 #pragma once
 #include "common.h"
+#include "TimeBitset.h"
+#include "AgentCell.h"
 
 #define NO_AGENT -1
 
 class PathTable
 {
 public:
+    // how the agents of the paths are stored: table[location][timestep], time-major chunks of
+    // CHUNK_TIMESTEPS timesteps of all locations, or sorted runs of timesteps of one agent per location.
+    // Time-major chunks are dense, so a time-major path table takes 4 * map_size * makespan bytes however few
+    // locations its paths visit, e.g., 2 MB per chunk and about 130 MB for makespan 500 on a 256x256 map.
+    enum Layout { LOCATION_MAJOR, TIME_MAJOR, SPARSE };
+
     int makespan = 0;
-    vector< vector<int> > table; // this stores the collision-free paths, the value is the id of the agent
     vector<int> goals; // this stores the goal locatons of the paths: key is the location, while value is the timestep when the agent reaches the goal
-    void reset() { auto map_size = table.size(); table.clear(); table.resize(map_size); goals.assign(map_size, MAX_COST); makespan = 0; }
+    // the occupied timesteps of each location as sorted, disjoint [t_min, t_max) intervals,
+    // kept up to date by insertPath and deletePath so that SIPP does not scan table
+    vector< vector< pair<int, int> > > reservations;
+    void reset()
+    {
+        auto map_size = goals.size();
+        table.clear();
+        if (layout == LOCATION_MAJOR)
+            table.resize(map_size);
+        runs.clear();
+        if (layout == SPARSE)
+            runs.resize(map_size);
+        reservations.clear();
+        reservations.resize(map_size);
+        goals.assign(map_size, MAX_COST);
+        goal_times.clear();
+        makespan = 0;
+    }
+    bool empty() const { return goals.empty(); } // the table has no locations
+    inline int getAgent(int location, int t) const // the agent at location at timestep t, or NO_AGENT
+    {
+        if (t < 0)
+            return NO_AGENT;
+        if (layout == TIME_MAJOR)
+        {
+            size_t chunk = (size_t) t / CHUNK_TIMESTEPS;
+            return chunk < table.size() ? table[chunk][location * CHUNK_TIMESTEPS + t % CHUNK_TIMESTEPS] : NO_AGENT;
+        }
+        if (layout == SPARSE)
+        {
+            // the reservations tell whether any run covers t; if so, it is the last run that starts at or
+            // before t and ends after t, which is not the last run that starts at or before t if runs overlap
+            const auto& intervals = reservations[location];
+            auto interval = std::upper_bound(intervals.begin(), intervals.end(), t,
+                                             [](int t, const pair<int, int>& interval) { return t < interval.second; });
+            if (interval == intervals.end() or t < interval->first)
+                return NO_AGENT;
+            const auto& location_runs = runs[location];
+            auto it = std::upper_bound(location_runs.begin(), location_runs.end(), t,
+                                       [](int t, const Run& run) { return t < run.t_min; });
+            do
+                --it;
+            while (it->t_max <= t);
+            return it->agent;
+        }
+        return t < (int) table[location].size() ? table[location][t] : NO_AGENT;
+    }
     void insertPath(int agent_id, const Path& path);
     void deletePath(int agent_id, const Path& path);
     bool constrained(int from, int to, int to_time) const;
@@ -18,16 +71,74 @@ public:
     void get_agents(set<int>& conflicting_agents, int neighbor_size, int loc) const;
     void getConflictingAgents(int agent_id, set<int>& conflicting_agents, int from, int to, int to_time) const;;
     int getHoldingTime(int location, int earliest_timestep) const;
-    explicit PathTable(int map_size = 0) : table(map_size), goals(map_size, MAX_COST) {}
+    explicit PathTable(int map_size = 0) : goals(map_size, MAX_COST), reservations(map_size), layout(default_layout)
+    {
+        if (layout == LOCATION_MAJOR)
+            table.resize(map_size);
+        else if (layout == SPARSE)
+            runs.resize(map_size);
+    }
+    static void setLayout(Layout layout) { default_layout = layout; } // of the path tables constructed afterwards
+private:
+    struct Run
+    {
+        int t_min;
+        int t_max;
+        int agent;
+    };
+    static const int CHUNK_TIMESTEPS = 8;
+    static Layout default_layout;
+    Layout layout;
+    // this stores the collision-free paths, the value is the id of the agent:
+    // table[location][timestep], or table[timestep / CHUNK_TIMESTEPS][location * CHUNK_TIMESTEPS + timestep % CHUNK_TIMESTEPS]
+    vector< vector<int> > table;
+    // the sparse layout instead stores the agent of each wait run [t_min, t_max) of the paths, sorted by t_min,
+    // so that its memory is proportional to the lengths of the paths rather than to the visited locations times makespan.
+    // It keeps reservations as well, which duplicate part of the runs: on Paris_1_256 with 500 agents,
+    // the runs take 3.3 MB and the reservations 2.7 MB
+    vector< vector<Run> > runs;
+    multiset<int> goal_times; // the goal timesteps of the paths, the last of which is the makespan
+
+    int getHorizon(int location) const // the agents at location are NO_AGENT from this timestep on
+    {
+        switch (layout)
+        {
+            case TIME_MAJOR: return (int) table.size() * CHUNK_TIMESTEPS;
+            case SPARSE: return runs[location].empty() ? 0 : runs[location].back().t_max;
+            default: return (int) table[location].size();
+        }
+    }
+    int& at(int location, int t); // the entry of location at timestep t, which is allocated if needed
+    void insertRun(int location, int t_min, int t_max, int agent_id);
+    void deleteRun(int location, int t_min, int t_max, int agent_id);
+    void reserve(int location, int t_min, int t_max);
+    void unreserve(int location, int t_min, int t_max);
 };
 
 class PathTableWC // with collisions
 {
 public:
     int makespan = 0;
-    vector< vector< list<int> > > table; // this stores the paths, the value is the id of the agent
+    vector< vector<AgentCell> > table; // this stores the paths, the value is the ids of the agents
     vector<int> goals; // this stores the goal locatons of the paths: key is the location, while value is the timestep when the agent reaches the goal
-    void reset() { auto map_size = table.size(); table.clear(); table.resize(map_size); goals.assign(map_size, MAX_COST); makespan = 0; }
+    // the timesteps when each location is occupied by at least one agent and by at least two agents,
+    // so that the queries over the future of a location do not scan table
+    vector<TimeBitset> occupied;
+    vector<TimeBitset> crowded;
+    vector<int> last_timesteps; // the last timestep when each location is occupied, or -1
+    multiset<int> goal_times; // the goal timesteps of the paths, the last of which is the makespan
+    void reset()
+    {
+        auto map_size = table.size();
+        table.clear();
+        table.resize(map_size);
+        occupied.assign(map_size, TimeBitset());
+        crowded.assign(map_size, TimeBitset());
+        last_timesteps.assign(map_size, -1);
+        goals.assign(map_size, MAX_COST);
+        goal_times.clear();
+        makespan = 0;
+    }
     void insertPath(int agent_id, const Path& path);
     void insertPath(int agent_id);
     void deletePath(int agent_id);
@@ -41,7 +152,7 @@ public:
     int getAgentWithTarget(int target_location, int latest_timestep) const;
     void clear();
     explicit PathTableWC(int map_size = 0, int num_of_agents = 0) : table(map_size), goals(map_size, MAX_COST),
-        paths(num_of_agents, nullptr) {}
+        occupied(map_size), crowded(map_size), last_timesteps(map_size, -1), paths(num_of_agents, nullptr) {}
 private:
     vector<const Path*> paths;
 };
\ No newline at end of file
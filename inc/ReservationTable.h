@@ -9,23 +9,92 @@ class ReservationTable
 public:
     const ConstraintTable& constraint_table;
 
-    ReservationTable(const ConstraintTable& constraint_table, int goal_location) :
-        constraint_table(constraint_table), goal_location(goal_location), sit(constraint_table.map_size) {}
+    ReservationTable(const ConstraintTable& constraint_table, int goal_location);
+    ~ReservationTable();
 
-    list<tuple<int, int, int, bool, bool> > get_safe_intervals(int from, int to, int lower_bound, int upper_bound);
+    // calls visitor(upper_bound, low, high, vertex collision, edge collision) for the intervals at to that
+    // can be reached from from in [lower_bound, upper_bound), in increasing order, until visitor returns false
+    template <class Visitor>
+    void for_each_safe_interval(int from, int to, int lower_bound, int upper_bound, Visitor visitor);
     Interval get_first_safe_interval(size_t location);
     bool find_safe_interval(Interval& interval, size_t location, int t_min);
 
 private:
+    // the vectors of the tables of a thread, which the next table of the thread reuses, as SIPP uses the
+    // tables of a thread one at a time, so that a table does not initialize sit for the entire map
+    struct Storage
+    {
+        vector<pair<int, int>> sit;
+        vector<Interval> intervals;
+        vector<Interval> location_intervals;
+        vector<Interval> remaining_intervals;
+        vector<int> built_locations; // whose entries of sit the destructor resets
+        bool in_use = false;
+    };
+    static thread_local Storage storage;
+
     int goal_location;
-	// Safe Interval Table (SIT)
-	typedef vector< list<Interval> > SIT;
-    SIT sit; // location -> [t_min, t_max), num_of_collisions
-    void insert2SIT(int location, int t_min, int t_max);
+	// Safe Interval Table (SIT): the sorted intervals of each visited location are stored consecutively in intervals
+    vector<pair<int, int>>& sit; // location -> [first, last) in intervals, or {-1, -1} if not built yet
+    vector<Interval>& intervals; // [t_min, t_max), has collision
+    vector<Interval>& location_intervals; // the intervals of the location that updateSIT is building
+    vector<Interval>& remaining_intervals; // scratch of removeReservationsFromSIT
+    void insert2SIT(int t_min, int t_max); // into location_intervals
+    void removeReservationsFromSIT(const vector< pair<int, int> >& reservations);
     void insertSoftConstraint2SIT(int location, int t_min, int t_max);
 	// void mergeIntervals(list<Interval >& intervals) const;
 	void updateSIT(int location); // update SIT at the given location
     int get_earliest_arrival_time(int from, int to, int lower_bound, int upper_bound) const;
     int get_earliest_no_collision_arrival_time(int from, int to, const Interval& interval,
                                                int lower_bound, int upper_bound) const;
-};
\ No newline at end of file
+};
+
+
+template <class Visitor>
+void ReservationTable::for_each_safe_interval(int from, int to, int lower_bound, int upper_bound, Visitor visitor)
+{
+    if (lower_bound >= upper_bound)
+        return;
+
+    if (sit[to].first < 0)
+        updateSIT(to);
+
+    for (int i = sit[to].first; i < sit[to].second; i++)
+    {
+        const auto interval = intervals[i];
+        if (lower_bound >= get<1>(interval))
+            continue;
+        else if (upper_bound <= get<0>(interval))
+            break;
+        // the interval overlaps with [lower_bound, upper_bound)
+        auto t1 = get_earliest_arrival_time(from, to,
+                max(lower_bound, get<0>(interval)), min(upper_bound, get<1>(interval)));
+        if (t1 < 0) // the interval is not reachable
+            continue;
+        else if (get<2>(interval)) // the interval has collisions
+        {
+            if (!visitor(get<1>(interval), t1, get<1>(interval), true, false))
+                return;
+        }
+        else // the interval does not have collisions
+        { // so we need to check the move action has collisions or not
+            auto t2 = get_earliest_no_collision_arrival_time(from, to, interval, t1, upper_bound);
+            if (t1 == t2)
+            {
+                if (!visitor(get<1>(interval), t1, get<1>(interval), false, false))
+                    return;
+            }
+            else if (t2 < 0)
+            {
+                if (!visitor(get<1>(interval), t1, get<1>(interval), false, true))
+                    return;
+            }
+            else
+            {
+                if (!visitor(get<1>(interval), t1, t2, false, true) ||
+                    !visitor(get<1>(interval), t2, get<1>(interval), false, false))
+                    return;
+            }
+        }
+    }
+}
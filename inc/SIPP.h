@@ -2,6 +2,8 @@
 #include <boost/functional/hash.hpp>
 #include "SingleAgentSolver.h"
 #include "ReservationTable.h"
+#include "NodeArena.h"
+#include "NodeTable.h"
 
 class SIPPNode: public LLNode
 {
@@ -11,9 +13,12 @@ public:
 	typedef boost::heap::pairing_heap< SIPPNode*, compare<SIPPNode::secondary_compare_node> >::handle_type focal_handle_t;
 	open_handle_t open_handle;
 	focal_handle_t focal_handle;
+	BucketHandle<2> open_bucket;
+	BucketHandle<3> focal_bucket;
 	int high_generation; // the upper bound with respect to generation
     int high_expansion; // the upper bound with respect to expansion
 	bool collision_v;
+	SIPPNode* next_equal = nullptr; // the next node in the table with the same TableKey
     SIPPNode() : LLNode() {}
 	SIPPNode(int loc, int g_val, int h_val, SIPPNode* parent, int timestep, int high_generation, int high_expansion,
 	        bool collision_v, int num_of_conflicts) :
@@ -21,7 +26,7 @@ public:
             high_expansion(high_expansion), collision_v(collision_v) {}
 	// SIPPNode(const SIPPNode& other): LLNode(other), high_generation(other.high_generation), high_expansion(other.high_expansion),
         //                              collision_v(other.collision_v) {}
-	~SIPPNode() {}
+	~SIPPNode() = default;
 
 	void copy(const SIPPNode& other) // copy everything except for handles
     {
@@ -58,6 +63,16 @@ public:
                         //min(get<1>(n1->interval), get<1>(n2->interval))); //overlapping time intervals
 		}
 	};
+
+	// The fields compared by eqnode packed into 64 bits, for NodeTable
+	struct TableKey
+	{
+		uint64_t operator()(const SIPPNode* n) const
+		{
+			return ((uint64_t) n->location << 32) | ((uint64_t) n->high_generation << 2) |
+				((uint64_t) n->wait_at_goal << 1) | (uint64_t) n->is_goal;
+		}
+	};
 };
 
 class SIPP: public SingleAgentSolver
@@ -78,31 +93,44 @@ public:
     int getTravelTime(int start, int end, const ConstraintTable& constraint_table, int upper_bound);
 
 	string getName() const { return "SIPP"; }
+	static const NodeArena<SIPPNode>& getNodeArena() { return node_arena; } // of the calling thread
 
 	SIPP(const Instance& instance, int agent):
-		SingleAgentSolver(instance, agent) {}
+		SingleAgentSolver(instance, agent), open_list(use_bucket_queues), focal_list(use_bucket_queues) {}
 
 private:
-	// define typedefs and handles for heap
-	typedef boost::heap::pairing_heap< SIPPNode*, boost::heap::compare<LLNode::compare_node> > heap_open_t;
-	typedef boost::heap::pairing_heap< SIPPNode*, boost::heap::compare<LLNode::secondary_compare_node> > heap_focal_t;
-	heap_open_t open_list;
-	heap_focal_t focal_list;
+	// define typedefs for OPEN and FOCAL
+	typedef NodeQueue<SIPPNode, LLNode::compare_node, LLNode::bucket_key, 2,
+	        &SIPPNode::open_handle, &SIPPNode::open_bucket> open_queue_t;
+	typedef NodeQueue<SIPPNode, LLNode::secondary_compare_node, LLNode::secondary_bucket_key, 3,
+	        &SIPPNode::focal_handle, &SIPPNode::focal_bucket> focal_queue_t;
+	open_queue_t open_list;
+	focal_queue_t focal_list;
 
-	// define typedef for hash_map
-	typedef boost::unordered_map<SIPPNode*, list<SIPPNode*>, SIPPNode::NodeHasher, SIPPNode::eqnode> hashtable_t;
-    hashtable_t allNodes_table;
-    list<SIPPNode*> useless_nodes;
+	// define typedef for hash_map, which stores the first of the equal nodes (chained by next_equal)
+	typedef NodeTable<SIPPNode, SIPPNode::TableKey> hashtable_t;
+    static thread_local hashtable_t allNodes_table; // one per thread, like node_arena
+    // one per thread, shared by the SIPP solvers of that thread, as their searches run one at a time
+    static thread_local NodeArena<SIPPNode> node_arena;
+    template <class... Args>
+    inline SIPPNode* createNode(Args&&... args) // the node gets a new tie-breaking key
+    {
+        auto node = node_arena.create(std::forward<Args>(args)...);
+        node->tie_breaking = tie_breaking_rng();
+        return node;
+    }
     // Path findNoCollisionPath(const ConstraintTable& constraint_table);
 
     void updatePath(const LLNode* goal, std::vector<PathEntry> &path);
 
 	inline void pushNodeToOpenAndFocal(SIPPNode* node);
     inline void pushNodeToFocal(SIPPNode* node);
+    inline void insertNodeToTable(SIPPNode* node);
     inline void eraseNodeFromLists(SIPPNode* node);
 	void updateFocalList();
 	void releaseNodes();
     bool dominanceCheck(SIPPNode* new_node);
+    SIPPNode* followHeuristicToGoal(SIPPNode* curr, ReservationTable& reservation_table, vector<bool>& dead_ends);
 	void printSearchTree() const;
 };
 
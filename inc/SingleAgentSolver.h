@@ -1,6 +1,9 @@
 ﻿#pragma once
+#include <random>
 #include "Instance.h"
 #include "ConstraintTable.h"
+#include "HeuristicTable.h"
+#include "NodeQueue.h"
 
 class LLNode // low-level node
 {
@@ -14,6 +17,7 @@ public:
 	bool in_openlist = false;
 	bool wait_at_goal = false; // the action is to wait at the goal vertex or not. This is used for >lenghth constraints
     bool is_goal = false;
+	unsigned int tie_breaking = 0; // random key drawn by the solver that generates the node, for the remaining ties
 	// the following is used to comapre nodes in the OPEN list
 	struct compare_node
 	{
@@ -24,7 +28,7 @@ public:
             {
                 if (n1->h_val == n2->h_val)
                 {
-                    return rand() % 2 == 0;   // break ties randomly
+                    return n1->tie_breaking >= n2->tie_breaking;   // break ties randomly
                 }
                 return n1->h_val >= n2->h_val;  // break ties towards smaller h_vals (closer to goal location)
             }
@@ -43,7 +47,7 @@ public:
                 {
                     if (n1->h_val == n2->h_val)
                     {
-                        return rand() % 2 == 0;   // break ties randomly
+                        return n1->tie_breaking >= n2->tie_breaking;   // break ties randomly
                     }
                     return n1->h_val >= n2->h_val;  // break ties towards smaller h_vals (closer to goal location)
                 }
@@ -53,6 +57,19 @@ public:
 		}
 	};  // used by FOCAL (heap) to compare nodes (top of the heap has min number-of-conflicts)
 
+	// keys of the nodes in the bucket versions of OPEN and FOCAL, in the same order as the comparators above
+	struct bucket_key
+	{
+		std::array<int, 2> operator()(const LLNode* n) const { return {{n->g_val + n->h_val, n->h_val}}; }
+	};
+	struct secondary_bucket_key
+	{
+		std::array<int, 3> operator()(const LLNode* n) const
+		{
+			return {{n->num_of_conflicts, n->g_val + n->h_val, n->h_val}};
+		}
+	};
+
 
 	LLNode() {}
 	LLNode(int location, int g_val, int h_val, LLNode* parent, int timestep, int num_of_conflicts) :
@@ -71,6 +88,7 @@ public:
 		num_of_conflicts = other.num_of_conflicts;
 		wait_at_goal = other.wait_at_goal;
 		is_goal = other.is_goal;
+		tie_breaking = other.tie_breaking;
 	}
     inline int getFVal() const { return g_val + h_val; }
 };
@@ -91,7 +109,7 @@ public:
 
 	int start_location;
 	int goal_location;
-	vector<int> my_heuristic;  // this is the precomputed heuristic for this agent
+	HeuristicTable my_heuristic;  // this is the precomputed heuristic for this agent, shared with agents of the same goal
 	int compute_heuristic(int from, int to) const  // compute admissible heuristic between two locations
 	{
 		return max(get_DH_heuristic(from, to), instance.getManhattanDistance(from, to));
@@ -109,8 +127,8 @@ public:
     virtual int getTravelTime(int start, int end, const ConstraintTable& constraint_table, int upper_bound) = 0;
 	virtual string getName() const = 0;
 
-	list<int> getNextLocations(int curr) const; // including itself and its neighbors
-	list<int> getNeighbors(int curr) const { return instance.getNeighbors(curr); }
+	LocationSpan getNextLocations(int curr) const { return instance.getNextLocations(curr); } // including itself and its neighbors
+	LocationSpan getNeighbors(int curr) const { return instance.getNeighbors(curr); }
     uint64_t getNumExpanded() const { return num_expanded; }
 	// int getStartLocation() const {return instance.start_locations[agent]; }
 	// int getGoalLocation() const {return instance.goal_locations[agent]; }
@@ -120,9 +138,14 @@ public:
 		start_location(instance.start_locations[agent]),
 		goal_location(instance.goal_locations[agent])
 	{
+		std::seed_seq seed{random_seed, agent};
+		tie_breaking_rng.seed(seed);
 		compute_heuristics();
 	}
 	virtual ~SingleAgentSolver()= default;
+    // OPEN and FOCAL of the solvers constructed afterwards are bucket queues instead of pairing heaps
+    static void setBucketQueues(bool bucketed) { use_bucket_queues = bucketed; }
+    static void setSeed(int seed) { random_seed = seed; } // of the tie-breaking keys of the solvers constructed afterwards
     void reset()
     {
         if (num_generated > 0)
@@ -135,8 +158,13 @@ public:
         num_expanded = 0;
         num_generated = 0;
         num_reopened = 0;
+        if (!my_heuristic.isExact() && num_runs >= (uint64_t) HeuristicStore::getHotSearches())
+            my_heuristic = HeuristicStore::get(instance, goal_location); // this agent is replanned often
     }
 protected:
+    static bool use_bucket_queues;
+    static int random_seed;
+    std::minstd_rand tie_breaking_rng; // seeded by random_seed and the agent, so that searches are reproducible
     uint64_t num_expanded = 0;
     uint64_t num_generated = 0;
     uint64_t num_reopened = 0;
@@ -145,6 +173,6 @@ protected:
 	double w = 1; // suboptimal bound
 
 	void compute_heuristics();
-	int get_DH_heuristic(int from, int to) const { return abs(my_heuristic[from] - my_heuristic[to]); }
+	int get_DH_heuristic(int from, int to) const { return my_heuristic.getDifferentialHeuristic(from, to); }
 };
 
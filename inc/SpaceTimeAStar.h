@@ -1,5 +1,7 @@
 ﻿#pragma once
 #include "SingleAgentSolver.h"
+#include "NodeArena.h"
+#include "NodeTable.h"
 
 
 class AStarNode: public LLNode
@@ -10,6 +12,8 @@ public:
 	typedef pairing_heap< AStarNode*, compare<LLNode::secondary_compare_node> >::handle_type focal_handle_t;
 	open_handle_t open_handle;
 	focal_handle_t focal_handle;
+	BucketHandle<2> open_bucket;
+	BucketHandle<3> focal_bucket;
 
 	AStarNode() : LLNode() {}
     AStarNode(const AStarNode& other) : LLNode(other) {} // copy everything except for handles
@@ -17,7 +21,7 @@ public:
 		LLNode(loc, g_val, h_val, parent, timestep, num_of_conflicts) {}
 
 
-	~AStarNode() {}
+	~AStarNode() = default;
 
 	// The following is used by for generating the hash value of a nodes
 	struct NodeHasher
@@ -44,6 +48,16 @@ public:
 						s1->is_goal == s2->is_goal);
 		}
 	};
+
+	// The fields compared by eqnode packed into 64 bits, for NodeTable
+	struct TableKey
+	{
+		uint64_t operator()(const AStarNode* n) const
+		{
+			return ((uint64_t) n->location << 32) | ((uint64_t) n->timestep << 2) |
+				((uint64_t) n->wait_at_goal << 1) | (uint64_t) n->is_goal;
+		}
+	};
 };
 
 
@@ -73,20 +87,32 @@ public:
     int getTravelTime(int start, int end, const ConstraintTable& constraint_table, int upper_bound);
 
 	string getName() const { return "AStar"; }
+	static const NodeArena<AStarNode>& getNodeArena() { return node_arena; } // of the calling thread
 
 	SpaceTimeAStar(const Instance& instance, int agent):
-		SingleAgentSolver(instance, agent) {}
+		SingleAgentSolver(instance, agent), open_list(use_bucket_queues), focal_list(use_bucket_queues) {}
 
 private:
-	// define typedefs and handles for heap
-	typedef pairing_heap< AStarNode*, compare<AStarNode::compare_node> > heap_open_t;
-	typedef pairing_heap< AStarNode*, compare<AStarNode::secondary_compare_node> > heap_focal_t;
-	heap_open_t open_list;
-	heap_focal_t focal_list;
+	// define typedefs for OPEN and FOCAL
+	typedef NodeQueue<AStarNode, LLNode::compare_node, LLNode::bucket_key, 2,
+	        &AStarNode::open_handle, &AStarNode::open_bucket> open_queue_t;
+	typedef NodeQueue<AStarNode, LLNode::secondary_compare_node, LLNode::secondary_bucket_key, 3,
+	        &AStarNode::focal_handle, &AStarNode::focal_bucket> focal_queue_t;
+	open_queue_t open_list;
+	focal_queue_t focal_list;
 
 	// define typedef for hash_map
-	typedef unordered_set<AStarNode*, AStarNode::NodeHasher, AStarNode::eqnode> hashtable_t;
-	hashtable_t allNodes_table;
+	typedef NodeTable<AStarNode, AStarNode::TableKey> hashtable_t;
+	static thread_local hashtable_t allNodes_table; // one per thread, like node_arena
+	// one per thread, shared by the SpaceTimeAStar solvers of that thread, as their searches run one at a time
+	static thread_local NodeArena<AStarNode> node_arena;
+	template <class... Args>
+	inline AStarNode* createNode(Args&&... args) // the node gets a new tie-breaking key
+	{
+		auto node = node_arena.create(std::forward<Args>(args)...);
+		node->tie_breaking = tie_breaking_rng();
+		return node;
+	}
 
 	// Updates the path datamember
 	void updatePath(const LLNode* goal, vector<PathEntry> &path);
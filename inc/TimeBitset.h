@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+
+// Set of timesteps of one location, 64 timesteps per word, so that the queries over time ranges
+// handle a word at a time by popcount and by counting leading/trailing zeros.
+class TimeBitset
+{
+public:
+    bool empty() const { return words.empty(); } // no timestep has been set
+    bool test(int t) const
+    {
+        size_t w = (size_t) t >> 6;
+        return w < words.size() and (words[w] >> (t & 63)) & 1;
+    }
+    void set(int t)
+    {
+        size_t w = (size_t) t >> 6;
+        if (w >= words.size())
+            words.resize(w + 1, 0);
+        words[w] |= (uint64_t) 1 << (t & 63);
+    }
+    void reset(int t)
+    {
+        size_t w = (size_t) t >> 6;
+        if (w < words.size())
+            words[w] &= ~((uint64_t) 1 << (t & 63));
+    }
+    void clear() { words.clear(); }
+
+    int count(int first) const // the number of timesteps >= first
+    {
+        if (first < 0)
+            first = 0;
+        size_t w = (size_t) first >> 6;
+        if (w >= words.size())
+            return 0;
+        int rst = __builtin_popcountll(words[w] & (~(uint64_t) 0 << (first & 63)));
+        for (w++; w < words.size(); w++)
+            rst += __builtin_popcountll(words[w]);
+        return rst;
+    }
+    int last() const // the last timestep, or -1 if there is none
+    {
+        for (size_t w = words.size(); w > 0; w--)
+        {
+            if (words[w - 1] != 0)
+                return (int) (w - 1) * 64 + 63 - __builtin_clzll(words[w - 1]);
+        }
+        return -1;
+    }
+    // calls visitor(t) for the timesteps >= first in increasing order
+    template <class Visitor>
+    void visit(int first, Visitor visitor) const
+    {
+        if (first < 0)
+            first = 0;
+        for (size_t w = (size_t) first >> 6; w < words.size(); w++)
+        {
+            uint64_t word = words[w];
+            if (w == (size_t) first >> 6)
+                word &= ~(uint64_t) 0 << (first & 63);
+            while (word != 0)
+            {
+                visitor((int) w * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+private:
+    std::vector<uint64_t> words;
+};
@@ -21,6 +21,7 @@ using boost::unordered_set;
 using std::vector;
 using std::list;
 using std::set;
+using std::multiset;
 using std::map;
 using std::get;
 using std::tuple;
@@ -75,6 +76,7 @@ struct PIBTPPS_option{
     int windowSize ;
     bool winPIBTSoft ;
     int timestepLimit ;
+    int distBudgetMB ; // memory budget of the cached distance tables
 };
 
 
@@ -12,14 +12,22 @@ void CBS::updatePaths(CBSNode* curr)
 	for (int i = 0; i < num_of_agents; i++)
 		paths[i] = &paths_found_initially[i];
 	vector<bool> updated(num_of_agents, false);  // initialized for false
+	current_paths.resize(num_of_agents);
+	current_sources.resize(num_of_agents, nullptr);
+	generated_paths.clear();
 
 	while (curr != nullptr)
 	{
-		for (auto & path : curr->paths)
+		for (const auto & path : curr->paths)
 		{
 			if (!updated[path.first])
 			{
-				paths[path.first] = &(path.second);
+				if (current_sources[path.first] != &path.second) // not decompressed by the last call
+				{
+					path.second.decompress(current_paths[path.first]);
+					current_sources[path.first] = &path.second;
+				}
+				paths[path.first] = &current_paths[path.first];
 				updated[path.first] = true;
 			}
 		}
@@ -455,13 +463,14 @@ bool CBS::findPathForSingleAgent(CBSNode*  node, int ag, int lowerbound)
 	if (!new_path.empty())
 	{
 		assert(!isSamePath(*paths[ag], new_path));
-		node->paths.emplace_back(ag, new_path);
+		node->paths.emplace_back(ag, CompressedPath(new_path));
 		node->g_val = node->g_val - (int)paths[ag]->size() + (int)new_path.size();
         node->sum_of_costs = node->sum_of_costs - ((int)paths[ag]->size()) + ((int)new_path.size());
-		paths[ag] = &node->paths.back().second;
-		node->makespan = max(node->makespan, new_path.size());
+		generated_paths.push_back(std::move(new_path));
+		paths[ag] = &generated_paths.back();
+		node->makespan = max(node->makespan, paths[ag]->size());
         // update the cost based on what it should be
-        calcNodeCost(node, new_path, ag);
+        calcNodeCost(node, *paths[ag], ag);
 		return true;
 	}
 	else
@@ -1296,16 +1305,14 @@ bool CBS::solve(double _time_limit, int _cost_lowerbound, int _cost_upperbound)
 							if (path.first == p->first)
 							{
 								p->second = path.second;
-								paths[p->first] = &p->second;
+								current_sources[p->first] = nullptr; // changed in place
 								break;
 							}
 							++p;
 						}
 						if (p == curr->paths.end())
-						{
 							curr->paths.emplace_back(path);
-							paths[path.first] = &curr->paths.back().second;
-						}
+						// paths[path.first] already points at the new path in generated_paths
 					}
 					if (screen > 1)
 					{
@@ -1729,6 +1736,9 @@ void CBS::clear()
 	releaseNodes();
 	paths.clear();
 	paths_found_initially.clear();
+	current_paths.clear();
+	current_sources.clear();
+	generated_paths.clear();
 	dummy_start = nullptr;
 	goal_node = nullptr;
 	solution_found = false;
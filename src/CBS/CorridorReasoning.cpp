@@ -310,8 +310,7 @@ int CorridorReasoning::getBypassLengthByAStar(int start, int end, pair<int, int>
 			length = curr->g_val;
 			break;
 		}
-		list<int> next_locations = instance.getNeighbors(curr->location);
-		next_locations.emplace_back(curr->location);
+		auto next_locations = instance.getNextLocations(curr->location);
 		for (int next_location : next_locations)
 		{
 			int next_timestep = curr->timestep + 1;
@@ -49,7 +49,8 @@ bool PBS::solve(double _time_limit, int _node_limit, int _collsion_threshold)
 }
 
 PBS::PBS(vector<SingleAgentSolver*>& search_engines, PathTableWC & path_table, int screen):
-         search_engines(search_engines), path_table(path_table), screen(screen), num_of_agents(search_engines.size()) {}
+         search_engines(search_engines), path_table(path_table), screen(screen), num_of_agents(search_engines.size()),
+         current_paths(num_of_agents), current_sources(num_of_agents, nullptr) {}
 PBS::~PBS()
 {
     for (auto node : all_nodes)
@@ -87,8 +88,10 @@ bool PBS::generateRoot()
             assert(initial_paths[i] != nullptr and
                     initial_paths[i]->front().location == search_engines[i]->start_location and
                     initial_paths[i]->back().location == search_engines[i]->goal_location);
-            root_node->new_paths.emplace_back(i, *initial_paths[i]);
-            paths[i] = &root_node->new_paths.back().second;
+            root_node->new_paths.emplace_back(i, CompressedPath(*initial_paths[i]));
+            current_paths[i] = *initial_paths[i];
+            current_sources[i] = &root_node->new_paths.back().second;
+            paths[i] = &current_paths[i];
             root_node->sum_of_costs += (int)initial_paths[i]->size() - 1;
         }
     }
@@ -177,6 +180,9 @@ bool PBS::generateChild(PBSNode& parent, bool left_child)
         // Re-plan path
         if(!planPath(a1, *child, higher_agents, lower_agents))
         {
+            // a later node may reuse the addresses of its paths, which update must not take for current_sources
+            for (const auto& path_pair : child->new_paths)
+                current_sources[path_pair.first] = nullptr;
             delete child;
             return false;
         }
@@ -271,12 +277,14 @@ bool PBS::planPath(int agent, PBSNode& node, const set<int> & higher_agents, con
         return false;
     }
     assert(paths[agent] == nullptr or !isSamePath(*paths[agent], new_path));
-    node.new_paths.emplace_back(agent, new_path);
+    node.new_paths.emplace_back(agent, CompressedPath(new_path));
     if (paths[agent] == nullptr)
         node.sum_of_costs += (int)new_path.size() - 1;
     else
         node.sum_of_costs += - (int)paths[agent]->size() + (int)new_path.size();
-    paths[agent] = &node.new_paths.back().second;
+    current_paths[agent] = std::move(new_path);
+    current_sources[agent] = &node.new_paths.back().second;
+    paths[agent] = &current_paths[agent];
     // node.makespan = max(node.makespan, (int) new_path.size() - 1);
     return true;
 }
@@ -469,11 +477,16 @@ void PBS::update(PBSNode& node)
             if (curr->priority.second >= 0) // external priority constraint
                 lower_external_agents[curr->priority.second].push_back(curr->priority.first);
         }
-        for (auto & path_pair : curr->new_paths)
+        for (const auto & path_pair : curr->new_paths)
         {
             if (paths[path_pair.first] == nullptr)
             {
-                paths[path_pair.first] = &path_pair.second;
+                if (current_sources[path_pair.first] != &path_pair.second) // not decompressed already
+                {
+                    path_pair.second.decompress(current_paths[path_pair.first]);
+                    current_sources[path_pair.first] = &path_pair.second;
+                }
+                paths[path_pair.first] = &current_paths[path_pair.first];
             }
         }
     }
@@ -19,13 +19,7 @@ int ConstraintTable::getLastCollisionTimestep(int location) const
     if (path_table_for_CAT != nullptr)
         rst = path_table_for_CAT->getLastCollisionTimestep(location);
     if (!cat.empty())
-    {
-        for (auto t = cat[location].size() - 1; t > rst; t--)
-        {
-            if (cat[location][t])
-                return t;
-        }
-    }
+        rst = max(rst, cat[location].last());
     return rst;
 }
 void ConstraintTable::insert2CT(size_t from, size_t to, int t_min, int t_max)
@@ -35,7 +29,7 @@ void ConstraintTable::insert2CT(size_t from, size_t to, int t_min, int t_max)
 void ConstraintTable::insert2CT(size_t loc, int t_min, int t_max)
 {
 	assert(loc >= 0);
-	ct[loc].emplace_back(t_min, t_max);
+	ct.insert(loc, t_min, t_max);
 	if (t_max < MAX_TIMESTEP && t_max > ct_max_timestep)
 	{
         ct_max_timestep = t_max;
@@ -191,10 +185,7 @@ void ConstraintTable::insert2CAT(const Path& path)
     cat_goals[path.back().location] = path.size() - 1;
     for (auto timestep = (int)path.size() - 1; timestep >= 0; timestep--)
     {
-        int loc = path[timestep].location;
-        if (cat[loc].size() <= timestep)
-            cat[loc].resize(timestep + 1, false);
-        cat[loc][timestep] = true;
+        cat[path[timestep].location].set(timestep);
     }
     cat_max_timestep = max(cat_max_timestep, (int)path.size() - 1);
 }
@@ -247,17 +238,7 @@ bool ConstraintTable::constrained(size_t loc, int t) const
 			return true;  // violate the positive vertex constraint
 	}	
 
-	const auto& it = ct.find(loc);
-	if (it == ct.end())
-	{
-		return false;
-	}
-	for (const auto& constraint: it->second)
-	{
-		if (constraint.first <= t && t < constraint.second)
-			return true;
-	}
-	return false;
+	return ct.contains(loc, t);
 }
 bool ConstraintTable::constrained(size_t curr_loc, size_t next_loc, int next_t) const
 {
@@ -290,10 +271,9 @@ int ConstraintTable::getNumOfConflictsForStep(size_t curr_id, size_t next_id, in
 
     if (!cat.empty())
     {
-        if (cat[next_id].size() > next_timestep and cat[next_id][next_timestep])
+        if (cat[next_id].test(next_timestep))
             rst++;
-        if (curr_id != next_id and cat[next_id].size() >= next_timestep and cat[curr_id].size() > next_timestep and
-                cat[next_id][next_timestep - 1]and cat[curr_id][next_timestep])
+        if (curr_id != next_id and cat[next_id].test(next_timestep - 1) and cat[curr_id].test(next_timestep))
             rst++;
         if (cat_goals[next_id] < next_timestep)
             rst++;
@@ -306,10 +286,9 @@ bool ConstraintTable::hasConflictForStep(size_t curr_id, size_t next_id, int nex
         return true;
     if (!cat.empty())
     {
-        if (cat[next_id].size() > next_timestep and cat[next_id][next_timestep])
+        if (cat[next_id].test(next_timestep))
             return true;
-        if (curr_id != next_id and cat[next_id].size() >= next_timestep and cat[curr_id].size() > next_timestep and
-            cat[next_id][next_timestep - 1]and cat[curr_id][next_timestep])
+        if (curr_id != next_id and cat[next_id].test(next_timestep - 1) and cat[curr_id].test(next_timestep))
             return true;
         if (cat_goals[next_id] < next_timestep)
             return true;
@@ -321,9 +300,8 @@ bool ConstraintTable::hasEdgeConflict(size_t curr_id, size_t next_id, int next_t
     assert(curr_id != next_id);
     if (path_table_for_CAT != nullptr and path_table_for_CAT->hasEdgeCollisions(curr_id, next_id, next_timestep))
         return true;
-    return !cat.empty() and curr_id != next_id and cat[next_id].size() >= next_timestep and
-            cat[curr_id].size() > next_timestep and
-            cat[next_id][next_timestep - 1] and cat[curr_id][next_timestep];
+    return !cat.empty() and curr_id != next_id and
+            cat[next_id].test(next_timestep - 1) and cat[curr_id].test(next_timestep);
 }
 int ConstraintTable::getFutureNumOfCollisions(int loc, int t) const
 {
@@ -331,12 +309,7 @@ int ConstraintTable::getFutureNumOfCollisions(int loc, int t) const
     if (path_table_for_CAT != nullptr)
         rst = path_table_for_CAT->getFutureNumOfCollisions(loc, t);
     if (!cat.empty())
-    {
-        for (auto timestep = t + 1; timestep < cat[loc].size(); timestep++)
-        {
-            rst += (int)cat[loc][timestep];
-        }
-    }
+        rst += cat[loc].count(t + 1);
     return rst;
 }
 
@@ -348,12 +321,7 @@ int ConstraintTable::getHoldingTime(int location, int earliest_timestep) const
     if (path_table_for_CT!= nullptr)
         rst = path_table_for_CT->getHoldingTime(location, earliest_timestep);
     // CT
-	auto it = ct.find(location);
-	if (it != ct.end())
-	{
-		for (auto time_range : it->second)
-			rst = max(rst, time_range.second);
-	}
+	ct.visit(location, [&](int /*t_min*/, int t_max) { rst = max(rst, t_max); });
 	// Landmark
 	for (auto landmark : landmarks)
 	{
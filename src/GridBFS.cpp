@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <climits>
+#include "GridBFS.h"
+
+GridBFS::GridBFS(int num_of_rows, int num_of_cols, const std::vector<bool>& obstacles) :
+    num_of_rows(num_of_rows), num_of_cols(num_of_cols), stride((num_of_cols + 63) / 64 + 2),
+    free_cells((size_t) (num_of_rows + 2) * stride, 0)
+{
+    for (int loc = 0; loc < num_of_rows * num_of_cols; loc++)
+    {
+        if (!obstacles[loc])
+            free_cells[getWordIndex(loc)] |= getBit(loc);
+    }
+}
+
+
+template <class Visitor>
+void GridBFS::search(int source, Visitor visit) const
+{
+    std::vector<uint64_t> visited(free_cells.size(), 0);
+    std::vector<uint64_t> frontier(free_cells.size(), 0);
+    std::vector<uint64_t> next(free_cells.size(), 0);
+
+    int word = getWordIndex(source);
+    frontier[word] = visited[word] = getBit(source);
+    if (visit(0, word, frontier[word]))
+        return;
+
+    int first_row = word / stride, last_row = first_row; // rows that contain the frontier
+    for (int level = 1; first_row <= last_row; level++)
+    {
+        int new_first_row = INT_MAX, new_last_row = INT_MIN;
+        for (int row = std::max(first_row - 1, 1); row <= std::min(last_row + 1, num_of_rows); row++)
+        {
+            for (int i = row * stride + 1; i < (row + 1) * stride - 1; i++)
+            {
+                // cells left, right, above and below the frontier that are free and not visited yet
+                uint64_t cells = (frontier[i] << 1) | (frontier[i - 1] >> 63) |
+                                 (frontier[i] >> 1) | (frontier[i + 1] << 63) |
+                                 frontier[i - stride] | frontier[i + stride];
+                cells &= free_cells[i] & ~visited[i];
+                next[i] = cells;
+                if (cells == 0)
+                    continue;
+                visited[i] |= cells;
+                new_first_row = std::min(new_first_row, row);
+                new_last_row = row;
+                if (visit(level, i, cells))
+                    return;
+            }
+        }
+        std::fill(frontier.begin() + first_row * stride, frontier.begin() + (last_row + 1) * stride, 0);
+        std::swap(frontier, next);
+        first_row = new_first_row;
+        last_row = new_last_row;
+    }
+}
+
+
+void GridBFS::getDistances(int source, std::vector<int>& distances, int unreachable) const
+{
+    distances.assign((size_t) num_of_rows * num_of_cols, unreachable);
+    search(source, [&](int level, int word, uint64_t cells)
+    {
+        int loc = (word / stride - 1) * num_of_cols + (word % stride - 1) * 64;
+        while (cells != 0)
+        {
+            distances[loc + __builtin_ctzll(cells)] = level;
+            cells &= cells - 1;
+        }
+        return false;
+    });
+}
+
+
+bool GridBFS::isConnected(int start, int goal) const
+{
+    bool connected = false;
+    int goal_word = getWordIndex(goal);
+    uint64_t goal_bit = getBit(goal);
+    search(start, [&](int /*level*/, int word, uint64_t cells)
+    {
+        connected = (word == goal_word && (cells & goal_bit) != 0);
+        return connected;
+    });
+    return connected;
+}
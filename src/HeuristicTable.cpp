@@ -0,0 +1,358 @@
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include "HeuristicTable.h"
+
+std::map<HeuristicStore::Key, shared_ptr<const DistanceTable>> HeuristicStore::tables;
+DistanceTable::width_type HeuristicStore::width = DistanceTable::INT32;
+string HeuristicStore::cache_fname;
+uint64_t HeuristicStore::cache_map_hash = 0;
+int HeuristicStore::cache_map_size = 0;
+vector<bool> HeuristicStore::cache_obstacles;
+bool HeuristicStore::dirty = false;
+bool HeuristicStore::lazy = false;
+int HeuristicStore::num_of_landmarks = 0;
+int HeuristicStore::hot_searches = 0;
+std::map<uint64_t, shared_ptr<const Landmarks>> HeuristicStore::landmarks;
+
+static const char CACHE_MAGIC[8] = {'M', 'A', 'P', 'F', 'H', 'E', 'U', '1'};
+
+
+DistanceTable::DistanceTable(const vector<int>& distances, const Instance& instance, width_type width) :
+    width(width), size((int) distances.size())
+{
+    if (width == UINT16)
+    {
+        for (int d : distances)
+        {
+            if (d >= UINT16_MAX && d < MAX_TIMESTEP)
+            {
+                this->width = width = INT32; // too far for 16 bits
+                break;
+            }
+        }
+    }
+    switch (width)
+    {
+        case INT32:
+            values32 = distances;
+            values32_data = values32.data();
+            break;
+        case UINT16:
+            values16.resize(size);
+            for (int loc = 0; loc < size; loc++)
+                values16[loc] = distances[loc] == MAX_TIMESTEP ? UINT16_MAX : (uint16_t) distances[loc];
+            break;
+        case DELTA2:
+            codes.assign((size + 31) / 32, 0);
+            checkpoints.resize(codes.size());
+            int prev = 0;
+            for (int loc = 0; loc < size; loc++)
+            {
+                int value = distances[loc];
+                int pos = loc % 32;
+                if (pos == 0)
+                {
+                    checkpoints[loc / 32] = value;
+                    prev = value;
+                    continue;
+                }
+                if (instance.isObstacle(loc))
+                    value = prev; // blocked locations are never looked up
+                uint64_t code;
+                if (value == prev)
+                    code = 0;
+                else if (value == prev + 1)
+                    code = 1;
+                else if (value == prev - 1)
+                    code = 2;
+                else
+                {
+                    code = 3;
+                    jumps.emplace_back(loc, value);
+                }
+                codes[loc / 32] |= code << (2 * pos);
+                prev = value;
+            }
+            if (getMemory() > sizeof(uint16_t) * size) // too many jumps, e.g., on mazes
+                *this = DistanceTable(distances, instance, UINT16);
+            break;
+    }
+}
+
+
+vector<int> DistanceTable::decode(const vector<bool>& obstacles) const
+{
+    vector<int> distances(size);
+    for (int loc = 0; loc < size; loc++)
+        distances[loc] = obstacles[loc] ? MAX_TIMESTEP : (*this)[loc];
+    return distances;
+}
+
+
+size_t DistanceTable::getMemory() const
+{
+    return sizeof(int) * (width == INT32 ? size : 0) + sizeof(int) * checkpoints.size() + sizeof(uint16_t) * values16.size() +
+           sizeof(uint64_t) * codes.size() + sizeof(pair<int, int>) * jumps.size();
+}
+
+
+LazyHeuristic::LazyHeuristic(const Instance& instance, int goal_location, int start_location) :
+    instance(instance), start_location(start_location)
+{
+    entries[goal_location] = {0, false};
+    open_list.emplace(instance.getManhattanDistance(goal_location, start_location), 0, goal_location);
+}
+
+
+int LazyHeuristic::get(int loc)
+{
+    auto it = entries.find(loc);
+    if (it != entries.end() && it->second.closed)
+        return it->second.g_val;
+
+    // resume the search until loc is expanded
+    while (!open_list.empty())
+    {
+        int g_val = std::get<1>(open_list.top());
+        int curr = std::get<2>(open_list.top());
+        open_list.pop();
+        auto& entry = entries[curr];
+        if (entry.closed || entry.g_val < g_val)
+            continue; // stale copy of a location whose g-val has been improved
+        entry.closed = true;
+        num_expanded++;
+        for (int next : instance.getNeighbors(curr))
+        {
+            auto next_it = entries.find(next);
+            if (next_it == entries.end())
+                next_it = entries.emplace(next, Entry{g_val + 1, false}).first;
+            else if (next_it->second.closed || next_it->second.g_val <= g_val + 1)
+                continue;
+            next_it->second.g_val = g_val + 1;
+            open_list.emplace(g_val + 1 + instance.getManhattanDistance(next, start_location), g_val + 1, next);
+        }
+        if (curr == loc)
+            return g_val;
+    }
+    return MAX_TIMESTEP; // loc is not reachable from the goal location
+}
+
+
+HeuristicTable::HeuristicTable(const Instance& instance, shared_ptr<const Landmarks> landmarks, int goal_location) :
+    instance(&instance), landmarks(std::move(landmarks)), goal_location(goal_location)
+{
+    for (const auto& distances : this->landmarks->distances)
+        goal_distances.push_back(distances[goal_location]);
+}
+
+
+HeuristicTable HeuristicStore::get(const Instance& instance, int goal_location)
+{
+    Key key(instance.getMapHash(), goal_location);
+    auto it = tables.find(key);
+    if (it == tables.end())
+    {
+        it = tables.emplace(key, computeHeuristics(instance, goal_location)).first;
+        if (key.first == cache_map_hash)
+            dirty = true;
+    }
+    return HeuristicTable(it->second);
+}
+
+
+void HeuristicStore::precompute(const Instance& instance, const vector<int>& goal_locations, int num_of_threads)
+{
+    uint64_t map_hash = instance.getMapHash();
+    vector<int> missing;
+    for (int goal_location : goal_locations)
+    {
+        if (tables.find(Key(map_hash, goal_location)) == tables.end())
+            missing.push_back(goal_location);
+    }
+    std::sort(missing.begin(), missing.end());
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+    if (missing.empty())
+        return;
+
+    // the workers only write their own slots of results, and the store is updated afterwards by this thread
+    vector<shared_ptr<const DistanceTable>> results(missing.size());
+    std::atomic<size_t> next(0);
+    auto worker = [&]()
+    {
+        for (size_t i = next++; i < missing.size(); i = next++)
+            results[i] = computeHeuristics(instance, missing[i]);
+    };
+    vector<std::thread> threads;
+    for (int i = 1; i < min(num_of_threads, (int) missing.size()); i++)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+
+    for (size_t i = 0; i < missing.size(); i++)
+        tables.emplace(Key(map_hash, missing[i]), results[i]);
+    if (map_hash == cache_map_hash)
+        dirty = true;
+}
+
+
+shared_ptr<const DistanceTable> HeuristicStore::computeHeuristics(const Instance& instance, int goal_location)
+{
+    // every move costs 1 on the grid, so a BFS gives the same distances as a Dijkstra search
+    vector<int> heuristic;
+    instance.getGridBFS().getDistances(goal_location, heuristic, MAX_TIMESTEP);
+    return make_shared<DistanceTable>(heuristic, instance, width);
+}
+
+
+size_t HeuristicStore::getMemory()
+{
+    size_t memory = 0;
+    for (const auto& table : tables)
+        memory += table.second->getMemory();
+    return memory;
+}
+
+
+void HeuristicStore::setLandmarks(int num_of_landmarks, int hot_searches)
+{
+    HeuristicStore::num_of_landmarks = num_of_landmarks;
+    HeuristicStore::hot_searches = hot_searches;
+}
+
+
+HeuristicTable HeuristicStore::getLandmarkHeuristic(const Instance& instance, int goal_location)
+{
+    auto it = landmarks.find(instance.getMapHash());
+    if (it == landmarks.end())
+        it = landmarks.emplace(instance.getMapHash(), computeLandmarks(instance)).first;
+    return HeuristicTable(instance, it->second, goal_location);
+}
+
+
+HeuristicTable HeuristicStore::getLazyHeuristic(const Instance& instance, int goal_location, int start_location)
+{
+    return HeuristicTable(make_shared<LazyHeuristic>(instance, goal_location, start_location));
+}
+
+
+shared_ptr<const Landmarks> HeuristicStore::computeLandmarks(const Instance& instance)
+{
+    // farthest-point selection: each landmark is the location farthest from the previous ones
+    auto rst = make_shared<Landmarks>();
+    int first = 0;
+    while (first < instance.map_size && instance.isObstacle(first))
+        first++;
+    if (first == instance.map_size)
+        return rst;
+    vector<int> distances;
+    instance.getGridBFS().getDistances(first, distances, MAX_TIMESTEP);
+    vector<int> min_distances = distances;
+    for (int i = 0; i < num_of_landmarks; i++)
+    {
+        int next = first;
+        for (int loc = 0; loc < instance.map_size; loc++)
+        {
+            if (min_distances[loc] < MAX_TIMESTEP && min_distances[loc] > min_distances[next])
+                next = loc;
+        }
+        if (min_distances[next] == 0 && i > 0)
+            break; // no more distinct locations
+        instance.getGridBFS().getDistances(next, distances, MAX_TIMESTEP);
+        for (int loc = 0; loc < instance.map_size; loc++)
+            min_distances[loc] = min(min_distances[loc], distances[loc]);
+        rst->locations.push_back(next);
+        rst->distances.push_back(distances);
+    }
+    return rst;
+}
+
+
+void HeuristicStore::useBundledHeuristics(const Instance& instance)
+{
+    for (const auto& heuristic : instance.getBundledHeuristics())
+    {
+        tables.emplace(Key(instance.getMapHash(), heuristic.first),
+                make_shared<DistanceTable>(heuristic.second, instance.map_size, instance.getBundle()));
+    }
+}
+
+
+void HeuristicStore::useCacheFile(const Instance& instance)
+{
+    cache_fname = instance.getMapFile() + ".heuristics";
+    cache_map_hash = instance.getMapHash();
+    cache_map_size = instance.map_size;
+    cache_obstacles.resize(cache_map_size);
+    for (int loc = 0; loc < cache_map_size; loc++)
+        cache_obstacles[loc] = instance.isObstacle(loc);
+    dirty = false;
+
+    std::ifstream file(cache_fname, std::ios::binary);
+    if (!file.is_open())
+        return;
+    char magic[sizeof(CACHE_MAGIC)];
+    uint64_t map_hash;
+    int map_size, num_of_tables;
+    file.read(magic, sizeof(magic));
+    file.read((char*) &map_hash, sizeof(map_hash));
+    file.read((char*) &map_size, sizeof(map_size));
+    file.read((char*) &num_of_tables, sizeof(num_of_tables));
+    if (!file || !std::equal(magic, magic + sizeof(magic), CACHE_MAGIC) ||
+        map_hash != cache_map_hash || map_size != cache_map_size)
+    {
+        cerr << "Ignore heuristic cache file " << cache_fname << " as it does not match the map" << endl;
+        return;
+    }
+    for (int i = 0; i < num_of_tables; i++)
+    {
+        int goal_location;
+        vector<int> heuristic(map_size);
+        file.read((char*) &goal_location, sizeof(goal_location));
+        file.read((char*) heuristic.data(), sizeof(int) * map_size);
+        if (!file)
+        {
+            cerr << "Heuristic cache file " << cache_fname << " is truncated" << endl;
+            dirty = true; // rewrite it with the tables read so far
+            return;
+        }
+        tables.emplace(Key(map_hash, goal_location), make_shared<DistanceTable>(heuristic, instance, width));
+    }
+}
+
+
+void HeuristicStore::saveCacheFile()
+{
+    if (cache_fname.empty() || !dirty)
+        return;
+    // write to a temporary file first, so that an interrupted run never leaves a broken cache
+    string tmp_fname = cache_fname + ".tmp";
+    std::ofstream file(tmp_fname, std::ios::binary);
+    if (!file.is_open())
+    {
+        cerr << "Fail to save the heuristics to " << cache_fname << endl;
+        return;
+    }
+    auto first = tables.lower_bound(Key(cache_map_hash, INT_MIN));
+    auto last = tables.upper_bound(Key(cache_map_hash, INT_MAX));
+    int num_of_tables = (int) std::distance(first, last);
+    file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    file.write((const char*) &cache_map_hash, sizeof(cache_map_hash));
+    file.write((const char*) &cache_map_size, sizeof(cache_map_size));
+    file.write((const char*) &num_of_tables, sizeof(num_of_tables));
+    for (auto it = first; it != last; ++it)
+    {
+        file.write((const char*) &it->first.second, sizeof(int));
+        auto heuristic = it->second->decode(cache_obstacles);
+        file.write((const char*) heuristic.data(), sizeof(int) * cache_map_size);
+    }
+    file.close();
+    if (!file || std::rename(tmp_fname.c_str(), cache_fname.c_str()) != 0)
+    {
+        cerr << "Fail to save the heuristics to " << cache_fname << endl;
+        std::remove(tmp_fname.c_str());
+        return;
+    }
+    dirty = false;
+}
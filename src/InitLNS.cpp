@@ -108,7 +108,7 @@ bool InitLNS::run()
         {
             int a = neighbor.agents[i];
             if (replan_algo_name == "PP" || neighbor.agents.size() == 1)
-                neighbor.old_paths[i] = agents[a].path;
+                neighbor.old_paths[i] = CompressedPath(agents[a].path);
             path_table.deletePath(neighbor.agents[i]);
             neighbor.old_sum_of_costs += (int) agents[a].path.size() - 1;
         }
@@ -353,7 +353,7 @@ bool InitLNS::runPP()
             for (int i = 0; i < (int)neighbor.agents.size(); i++)
             {
                 int a = *p2;
-                agents[a].path = neighbor.old_paths[i];
+                neighbor.old_paths[i].decompress(agents[a].path);
                 path_table.insertPath(agents[a].id);
                 ++p2;
             }
@@ -738,17 +738,14 @@ int InitLNS::randomWalk(int agent_id)
            path_table.table[loc][t].empty() or
            (path_table.table[loc][t].size() == 1 and path_table.table[loc][t].front() == agent_id)))
     {
-        auto next_locs = instance.getNeighbors(loc);
-        next_locs.push_back(loc);
-        int step = rand() % next_locs.size();
-        auto it = next_locs.begin();
+        auto next_locs = instance.getNextLocations(loc);
         loc = *std::next(next_locs.begin(), rand() % next_locs.size());
         t = t + 1;
     }
     if (t > path_table.makespan)
         return NO_AGENT;
     else
-        return *std::next(path_table.table[loc][t].begin(), rand() % path_table.table[loc][t].size());
+        return path_table.table[loc][t][rand() % path_table.table[loc][t].size()];
 }
 
 void InitLNS::writeIterStatsToFile(const string & file_name) const
@@ -25,6 +25,9 @@ Instance::Instance(const string& map_fname, const string& agent_fname,
 			exit(-1);
 		}
 	}
+	computeMapHash();
+	grid_bfs = GridBFS(this->num_of_rows, this->num_of_cols, my_map);
+	buildNeighborTable();
 
 	succ = loadAgents();
 	if (!succ)
@@ -49,8 +52,8 @@ int Instance::randomWalk(int curr, int steps) const
 {
 	for (int walk = 0; walk < steps; walk++)
 	{
-		list<int> l = getNeighbors(curr);
-		vector<int> next_locations(l.cbegin(), l.cend());
+		auto l = getNeighbors(curr);
+		vector<int> next_locations(l.begin(), l.end());
 		auto rng = std::default_random_engine{};
 		std::shuffle(std::begin(next_locations), std::end(next_locations), rng);
 		for (int next : next_locations)
@@ -153,6 +156,7 @@ bool Instance::addObstacle(int obstacle)
 	if (my_map[obstacle])
 		return false;
 	my_map[obstacle] = true;
+	grid_bfs.setBlocked(obstacle, true);
 	int obstacle_x = getRowCoordinate(obstacle);
 	int obstacle_y = getColCoordinate(obstacle);
 	int x[4] = { obstacle_x, obstacle_x + 1, obstacle_x, obstacle_x - 1 };
@@ -177,6 +181,7 @@ bool Instance::addObstacle(int obstacle)
 		else
 		{
 			my_map[obstacle] = false;
+			grid_bfs.setBlocked(obstacle, false);
 			return false;
 		}
 	}
@@ -185,24 +190,7 @@ bool Instance::addObstacle(int obstacle)
 
 bool Instance::isConnected(int start, int goal)
 {
-	std::queue<int> open;
-	vector<bool> closed(map_size, false);
-	open.push(start);
-	closed[start] = true;
-	while (!open.empty())
-	{
-		int curr = open.front(); open.pop();
-		if (curr == goal)
-			return true;
-		for (int next : getNeighbors(curr))
-		{
-			if (closed[next])
-				continue;
-			open.push(next);
-			closed[next] = true;
-		}
-	}
-	return false;
+	return grid_bfs.isConnected(start, goal);
 }
 
 void Instance::generateConnectedRandomGrid(int rows, int cols, int obstacles)
@@ -234,7 +222,8 @@ void Instance::generateConnectedRandomGrid(int rows, int cols, int obstacles)
 	for (i = 0; i<num_of_rows; i++)
 		my_map[linearizeCoordinate(i, j)] = true;
 
-	// add obstacles uniformly at random
+	// add obstacles uniformly at random, keeping grid_bfs up to date with the map
+	grid_bfs = GridBFS(num_of_rows, num_of_cols, my_map);
 	i = 0;
 	while (i < obstacles)
 	{
@@ -303,6 +292,17 @@ bool Instance::loadMap()
 	return true;
 }
 
+void Instance::computeMapHash()
+{
+	// FNV-1a over the dimensions and the obstacle bits, so the value is stable across runs
+	map_hash = 14695981039346656037ULL;
+	auto mix = [&](uint64_t value) { map_hash = (map_hash ^ value) * 1099511628211ULL; };
+	mix(num_of_rows);
+	mix(num_of_cols);
+	for (int i = 0; i < map_size; i++)
+		mix(my_map[i]);
+}
+
 
 void Instance::printMap() const
 {
@@ -470,16 +470,26 @@ void Instance::saveNathan() const
 }
 
 
-list<int> Instance::getNeighbors(int curr) const
+void Instance::buildNeighborTable()
 {
-	list<int> neighbors;
-	int candidates[4] = {curr + 1, curr - 1, curr + num_of_cols, curr - num_of_cols};
-	for (int next : candidates)
+	neighbor_offsets.resize(map_size + 1);
+	neighbor_table.clear();
+	neighbor_table.reserve(map_size * 5);
+	for (int curr = 0; curr < map_size; curr++)
 	{
-		if (validMove(curr, next))
-			neighbors.emplace_back(next);
+		neighbor_offsets[curr] = (int) neighbor_table.size();
+		int candidates[4] = {curr + 1, curr - 1, curr + num_of_cols, curr - num_of_cols};
+		for (int next : candidates)
+		{
+			if (validMove(curr, next))
+				neighbor_table.push_back(next);
+		}
+		neighbor_table.push_back(curr);
 	}
-	return neighbors;
+	neighbor_offsets[map_size] = (int) neighbor_table.size();
+	neighbor_table.shrink_to_fit();
+	neighbor_offsets_data = neighbor_offsets.data();
+	neighbor_table_data = neighbor_table.data();
 }
 
 void Instance::savePaths(const string & file_name, const vector<Path*>& paths) const
@@ -0,0 +1,162 @@
+#include <cstring>
+#include "Instance.h"
+#include "MappedFile.h"
+
+// Layout of a bundle: the header, followed by the sections at the header's offsets,
+// each aligned to 8 bytes, so that the loader can use them in place
+struct BundleHeader
+{
+    char magic[8];
+    int32_t num_of_rows;
+    int32_t num_of_cols;
+    int32_t num_of_agents;
+    int32_t num_of_heuristics;
+    uint64_t map_hash;
+    int32_t nathan_benchmark;
+    int32_t map_fname_length;
+    int32_t agent_fname_length;
+    int32_t neighbor_table_size;
+    uint64_t names_offset; // map_fname and then agent_fname
+    uint64_t obstacles_offset; // one bit per location
+    uint64_t neighbor_offsets_offset; // map_size + 1 ints
+    uint64_t neighbor_table_offset; // neighbor_table_size ints
+    uint64_t starts_offset; // num_of_agents ints
+    uint64_t goals_offset; // num_of_agents ints
+    uint64_t heuristic_goals_offset; // num_of_heuristics ints
+    uint64_t heuristics_offset; // num_of_heuristics x map_size ints
+};
+
+static const char BUNDLE_MAGIC[8] = {'M', 'A', 'P', 'F', 'P', 'A', 'K', '1'};
+
+static inline uint64_t align8(uint64_t offset) { return (offset + 7) & ~(uint64_t) 7; }
+
+
+bool Instance::saveBundle(const string& bundle_fname, bool with_heuristics) const
+{
+    vector<int> heuristic_goals;
+    if (with_heuristics)
+    {
+        heuristic_goals = goal_locations;
+        std::sort(heuristic_goals.begin(), heuristic_goals.end());
+        heuristic_goals.erase(std::unique(heuristic_goals.begin(), heuristic_goals.end()), heuristic_goals.end());
+    }
+    vector<uint64_t> obstacles((map_size + 63) / 64, 0);
+    for (int loc = 0; loc < map_size; loc++)
+    {
+        if (my_map[loc])
+            obstacles[loc / 64] |= (uint64_t) 1 << (loc % 64);
+    }
+
+    BundleHeader header = {};
+    std::memcpy(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+    header.num_of_rows = num_of_rows;
+    header.num_of_cols = num_of_cols;
+    header.num_of_agents = num_of_agents;
+    header.num_of_heuristics = (int) heuristic_goals.size();
+    header.map_hash = map_hash;
+    header.nathan_benchmark = nathan_benchmark;
+    header.map_fname_length = (int) map_fname.size();
+    header.agent_fname_length = (int) agent_fname.size();
+    header.neighbor_table_size = neighbor_offsets_data[map_size];
+    header.names_offset = align8(sizeof(BundleHeader));
+    header.obstacles_offset = align8(header.names_offset + map_fname.size() + agent_fname.size());
+    header.neighbor_offsets_offset = align8(header.obstacles_offset + sizeof(uint64_t) * obstacles.size());
+    header.neighbor_table_offset = align8(header.neighbor_offsets_offset + sizeof(int) * (map_size + 1));
+    header.starts_offset = align8(header.neighbor_table_offset + sizeof(int) * header.neighbor_table_size);
+    header.goals_offset = align8(header.starts_offset + sizeof(int) * num_of_agents);
+    header.heuristic_goals_offset = align8(header.goals_offset + sizeof(int) * num_of_agents);
+    header.heuristics_offset = align8(header.heuristic_goals_offset + sizeof(int) * heuristic_goals.size());
+
+    std::ofstream file(bundle_fname, std::ios::binary);
+    if (!file.is_open())
+    {
+        cerr << "Fail to save the bundle to " << bundle_fname << endl;
+        return false;
+    }
+    auto write = [&](uint64_t offset, const void* data, size_t size)
+    {
+        while ((uint64_t) file.tellp() < offset)
+            file.put(0);
+        file.write((const char*) data, size);
+    };
+    write(0, &header, sizeof(header));
+    write(header.names_offset, map_fname.data(), map_fname.size());
+    write(header.names_offset + map_fname.size(), agent_fname.data(), agent_fname.size());
+    write(header.obstacles_offset, obstacles.data(), sizeof(uint64_t) * obstacles.size());
+    write(header.neighbor_offsets_offset, neighbor_offsets_data, sizeof(int) * (map_size + 1));
+    write(header.neighbor_table_offset, neighbor_table_data, sizeof(int) * header.neighbor_table_size);
+    write(header.starts_offset, start_locations.data(), sizeof(int) * num_of_agents);
+    write(header.goals_offset, goal_locations.data(), sizeof(int) * num_of_agents);
+    write(header.heuristic_goals_offset, heuristic_goals.data(), sizeof(int) * heuristic_goals.size());
+    vector<int> distances;
+    for (size_t i = 0; i < heuristic_goals.size(); i++)
+    {
+        grid_bfs.getDistances(heuristic_goals[i], distances, MAX_TIMESTEP);
+        write(header.heuristics_offset + sizeof(int) * map_size * i, distances.data(), sizeof(int) * map_size);
+    }
+    file.close();
+    if (!file)
+    {
+        cerr << "Fail to save the bundle to " << bundle_fname << endl;
+        return false;
+    }
+    return true;
+}
+
+
+Instance::Instance(const string& bundle_fname, int num_of_agents) : num_of_agents(num_of_agents)
+{
+    if (!loadBundle(bundle_fname))
+    {
+        cerr << "Bundle file " << bundle_fname << " not found or invalid." << endl;
+        exit(-1);
+    }
+}
+
+
+bool Instance::loadBundle(const string& bundle_fname)
+{
+    auto file = make_shared<MappedFile>(bundle_fname);
+    if (!file->isOpen() || file->getSize() < sizeof(BundleHeader))
+        return false;
+    const char* data = file->getData();
+    const auto& header = *(const BundleHeader*) data;
+    if (std::memcmp(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0 ||
+        header.heuristics_offset + sizeof(int) * (uint64_t) header.num_of_heuristics *
+        header.num_of_rows * header.num_of_cols > file->getSize())
+        return false;
+
+    num_of_rows = header.num_of_rows;
+    num_of_cols = header.num_of_cols;
+    map_size = num_of_rows * num_of_cols;
+    map_hash = header.map_hash;
+    nathan_benchmark = header.nathan_benchmark != 0;
+    map_fname.assign(data + header.names_offset, header.map_fname_length);
+    agent_fname.assign(data + header.names_offset + header.map_fname_length, header.agent_fname_length);
+
+    const auto* obstacles = (const uint64_t*) (data + header.obstacles_offset);
+    my_map.resize(map_size);
+    for (int loc = 0; loc < map_size; loc++)
+        my_map[loc] = (obstacles[loc / 64] >> (loc % 64)) & 1;
+    grid_bfs = GridBFS(num_of_rows, num_of_cols, my_map);
+    neighbor_offsets_data = (const int*) (data + header.neighbor_offsets_offset);
+    neighbor_table_data = (const int*) (data + header.neighbor_table_offset);
+
+    if (num_of_agents <= 0 || num_of_agents > header.num_of_agents)
+    {
+        if (num_of_agents > header.num_of_agents)
+            cerr << "The bundle has only " << header.num_of_agents << " agents" << endl;
+        num_of_agents = header.num_of_agents;
+    }
+    const auto* starts = (const int*) (data + header.starts_offset);
+    const auto* goals = (const int*) (data + header.goals_offset);
+    start_locations.assign(starts, starts + num_of_agents);
+    goal_locations.assign(goals, goals + num_of_agents);
+
+    const auto* heuristic_goals = (const int*) (data + header.heuristic_goals_offset);
+    const auto* heuristics = (const int*) (data + header.heuristics_offset);
+    for (int i = 0; i < header.num_of_heuristics; i++)
+        bundled_heuristics.emplace_back(heuristic_goals[i], heuristics + (size_t) map_size * i);
+    bundle = file;
+    return true;
+}
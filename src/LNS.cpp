@@ -4,7 +4,8 @@
 
 LNS::LNS(const Instance& instance, double time_limit, const string & init_algo_name, const string & replan_algo_name,
          const string & destory_name, int neighbor_size, int num_of_iterations, bool use_init_lns,
-         const string & init_destory_name, bool use_sipp, int screen, PIBTPPS_option pipp_option) :
+         const string & init_destory_name, bool use_sipp, int screen, PIBTPPS_option pipp_option,
+         int num_of_threads) :
          BasicLNS(instance, time_limit, neighbor_size, screen),
          init_algo_name(init_algo_name),  replan_algo_name(replan_algo_name), num_of_iterations(num_of_iterations),
          use_init_lns(use_init_lns),init_destory_name(init_destory_name),
@@ -32,12 +33,19 @@ LNS::LNS(const Instance& instance, double time_limit, const string & init_algo_n
     }
 
     int N = instance.getDefaultNumberOfAgents();
+    // the agents below then only look up the shared heuristic tables
+    if (num_of_threads > 1 && HeuristicStore::getNumOfLandmarks() == 0 && !HeuristicStore::isLazy())
+        HeuristicStore::precompute(instance, instance.getGoals(), num_of_threads);
     agents.reserve(N);
     for (int i = 0; i < N; i++)
         agents.emplace_back(instance, i, use_sipp);
     preprocessing_time = ((fsec)(Time::now() - start_time)).count();
     if (screen >= 2)
+    {
         cout << "Pre-processing time = " << preprocessing_time << " seconds." << endl;
+        cout << "Heuristic tables: " << HeuristicStore::getNumTables() << " tables, "
+             << HeuristicStore::getMemory() / 1048576.0 << " MB" << endl;
+    }
 }
 
 bool LNS::run()
@@ -140,7 +148,7 @@ bool LNS::run()
         for (int i = 0; i < (int)neighbor.agents.size(); i++)
         {
             if (replan_algo_name == "PP")
-                neighbor.old_paths[i] = agents[neighbor.agents[i]].path;
+                neighbor.old_paths[i] = CompressedPath(agents[neighbor.agents[i]].path);
             path_table.deletePath(neighbor.agents[i], agents[neighbor.agents[i]].path);
             neighbor.old_sum_of_costs += agents[neighbor.agents[i]].path.size() - 1;
         }
@@ -190,6 +198,14 @@ bool LNS::run()
          << "solution cost = " << sum_of_costs << ", "
          << "initial solution cost = " << initial_sum_of_costs << ", "
          << "failed iterations = " << num_of_failures << endl;
+    if (screen >= 2)
+    {
+        const auto& sipp_nodes = SIPP::getNodeArena();
+        const auto& astar_nodes = SpaceTimeAStar::getNodeArena();
+        cout << "Low-level nodes recycled: " << sipp_nodes.getNumRecycled() + astar_nodes.getNumRecycled() << " ("
+             << (sipp_nodes.getRecycledBytes() + astar_nodes.getRecycledBytes()) / 1048576.0 << " MB), node arenas: "
+             << (sipp_nodes.getMemory() + astar_nodes.getMemory()) / 1048576.0 << " MB" << endl;
+    }
     return true;
 }
 
@@ -406,7 +422,7 @@ bool LNS::runPP()
             for (int i = 0; i < (int)neighbor.agents.size(); i++)
             {
                 int a = *p2;
-                agents[a].path = neighbor.old_paths[i];
+                neighbor.old_paths[i].decompress(agents[a].path);
                 path_table.insertPath(agents[a].id, agents[a].path);
                 ++p2;
             }
@@ -426,7 +442,7 @@ bool LNS::runPPS(){
     auto* MT_S = new std::mt19937(0);
     PPS solver(&P,MT_S);
     solver.setTimeLimit(time_limit);
-//    solver.WarshallFloyd();
+    solver.setDistanceOracle(new LazyDistanceOracle(P.getG(), (size_t)pipp_option.distBudgetMB << 20));
     bool result = solver.solve();
     if (result)
         updatePIBTResult(P.getA(),shuffled_agents);
@@ -442,6 +458,7 @@ bool LNS::runPIBT(){
     auto MT_S = new std::mt19937(0);
     PIBT solver(&P,MT_S);
     solver.setTimeLimit(time_limit);
+    solver.setDistanceOracle(new LazyDistanceOracle(P.getG(), (size_t)pipp_option.distBudgetMB << 20));
     bool result = solver.solve();
     if (result)
         updatePIBTResult(P.getA(),shuffled_agents);
@@ -458,6 +475,7 @@ bool LNS::runWinPIBT(){
     auto MT_S = new std::mt19937(0);
     winPIBT solver(&P,pipp_option.windowSize,pipp_option.winPIBTSoft,MT_S);
     solver.setTimeLimit(time_limit);
+    solver.setDistanceOracle(new LazyDistanceOracle(P.getG(), (size_t)pipp_option.distBudgetMB << 20));
     bool result = solver.solve();
     if (result)
         updatePIBTResult(P.getA(),shuffled_agents);
@@ -469,20 +487,22 @@ MAPF LNS::preparePIBTProblem(vector<int>& shuffled_agents){
     // seed for problem and graph
     auto MT_PG = new std::mt19937(0);
 
-//    Graph* G = new SimpleGrid(instance);
-    Graph* G = new SimpleGrid(instance.getMapFile());
+    if (pibt_graph == nullptr)
+        pibt_graph = new InstanceGrid(instance);
+    else
+        pibt_graph->reset();
+    Graph* G = pibt_graph;
 
     std::vector<Task*> T;
     PIBT_Agents A;
 
     for (int i : shuffled_agents){
-        assert(G->existNode(agents[i].path_planner->start_location));
-        assert(G->existNode(agents[i].path_planner->goal_location));
-        auto a = new PIBT_Agent(G->getNode( agents[i].path_planner->start_location));
+        assert(pibt_graph->getNodeAt(agents[i].path_planner->start_location) != nullptr);
+        assert(pibt_graph->getNodeAt(agents[i].path_planner->goal_location) != nullptr);
+        auto a = new PIBT_Agent(pibt_graph->getNodeAt(agents[i].path_planner->start_location));
 
-//        PIBT_Agent* a = new PIBT_Agent(G->getNode( agents[i].path_planner.start_location));
         A.push_back(a);
-        Task* tau = new Task(G->getNode( agents[i].path_planner->goal_location));
+        Task* tau = new Task(pibt_graph->getNodeAt(agents[i].path_planner->goal_location));
 
 
         T.push_back(tau);
@@ -689,10 +709,11 @@ void LNS::randomWalk(int agent_id, int start_location, int start_timestep,
                      set<int>& conflicting_agents, int neighbor_size, int upperbound)
 {
     int loc = start_location;
+    vector<int> next_locs; // the untried next locations, reused across the steps
     for (int t = start_timestep; t < upperbound; t++)
     {
-        auto next_locs = instance.getNeighbors(loc);
-        next_locs.push_back(loc);
+        auto next_span = instance.getNextLocations(loc);
+        next_locs.assign(next_span.begin(), next_span.end());
         while (!next_locs.empty())
         {
             int step = rand() % next_locs.size();
@@ -0,0 +1,29 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MappedFile.h"
+
+MappedFile::MappedFile(const std::string& fname)
+{
+    int fd = open(fname.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED)
+        {
+            data = (const char*) addr;
+            size = st.st_size;
+        }
+    }
+    close(fd); // the mapping stays valid
+}
+
+MappedFile::~MappedFile()
+{
+    if (data != nullptr)
+        munmap((void*) data, size);
+}
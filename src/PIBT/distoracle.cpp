@@ -0,0 +1,135 @@
+/*
+ * distoracle.cpp
+ *
+ * Purpose: shortest-path distances for the PIBT-family solvers
+ */
+
+#include "distoracle.h"
+#include "grid.h"
+
+const int DistanceOracle::INF;
+
+LazyDistanceOracle::LazyDistanceOracle(Graph* _G, size_t _budget)
+  : G(_G), budget(_budget)
+{
+  localNodes = G->getNodes();
+  int maxId = -1;
+  for (auto v : localNodes) maxId = std::max(maxId, v->getId());
+  localIndex.assign(maxId + 1, -1);
+  for (int i = 0; i < (int)localNodes.size(); ++i) {
+    localIndex[localNodes[i]->getId()] = i;
+  }
+
+  // forward and reversed adjacency, so that a BFS never touches Node objects
+  int n = localNodes.size();
+  std::vector<int> inDegree(n, 0);
+  fwdOffsets.assign(n + 1, 0);
+  for (int i = 0; i < n; ++i) {
+    for (auto u : localNodes[i]->getNeighbor()) {
+      fwdEdges.push_back(localIndex[u->getId()]);
+      ++inDegree[localIndex[u->getId()]];
+    }
+    fwdOffsets[i + 1] = fwdEdges.size();
+  }
+  revOffsets.assign(n + 1, 0);
+  for (int i = 0; i < n; ++i) revOffsets[i + 1] = revOffsets[i] + inDegree[i];
+  revEdges.resize(fwdEdges.size());
+  std::vector<int> fill(revOffsets.begin(), revOffsets.end() - 1);
+  for (int i = 0; i < n; ++i) {
+    for (int k = fwdOffsets[i]; k < fwdOffsets[i + 1]; ++k) {
+      revEdges[fill[fwdEdges[k]]++] = i;
+    }
+  }
+
+  // on undirected grids, tables come from the bit-parallel grid BFS
+  Grid* grid = dynamic_cast<Grid*>(G);
+  useGridBFS = (grid != nullptr && !G->isDirected());
+  if (useGridBFS) {
+    std::vector<bool> obstacles(grid->getW() * grid->getH(), true);
+    for (auto v : localNodes) obstacles[v->getId()] = false;
+    gridBFS = GridBFS(grid->getH(), grid->getW(), obstacles);
+  }
+}
+
+const std::vector<int>& LazyDistanceOracle::getTable(int g) {
+  auto itr = tables.find(g);
+  if (itr != tables.end()) {  // known, move to the front of LRU
+    lru.splice(lru.begin(), lru, itr->second.lruPos);
+    return itr->second.d;
+  }
+
+  // new
+  lru.push_front(g);
+  Table& table = tables[g];
+  table.lruPos = lru.begin();
+  bfs(g, table.d);
+
+  shrink();
+  return table.d;
+}
+
+void LazyDistanceOracle::bfs(int g, std::vector<int>& d) {
+  if (useGridBFS) {
+    std::vector<int> cellDist;
+    gridBFS.getDistances(localNodes[g]->getId(), cellDist, INF);
+    d.resize(localNodes.size());
+    for (int i = 0; i < (int)localNodes.size(); ++i) {
+      d[i] = cellDist[localNodes[i]->getId()];
+    }
+    return;
+  }
+
+  // BFS from the goal over reversed edges
+  d.assign(localNodes.size(), INF);
+  std::vector<int> queue;
+  queue.reserve(localNodes.size());
+  d[g] = 0;
+  queue.push_back(g);
+  for (int head = 0; head < (int)queue.size(); ++head) {
+    int v = queue[head];
+    for (int k = revOffsets[v]; k < revOffsets[v + 1]; ++k) {
+      int u = revEdges[k];
+      if (d[u] != INF) continue;
+      d[u] = d[v] + 1;
+      queue.push_back(u);
+    }
+  }
+}
+
+void LazyDistanceOracle::shrink() {
+  // drop least recently used tables, but always keep the newest one
+  while (tables.size() > 1 && tables.size() * tableBytes() > budget) {
+    tables.erase(lru.back());
+    lru.pop_back();
+  }
+}
+
+void LazyDistanceOracle::setBudget(size_t _budget) {
+  budget = _budget;
+  shrink();
+}
+
+int LazyDistanceOracle::dist(Node* s, Node* g) {
+  if (s == g) return 0;
+  return getTable(localIndex[g->getId()])[localIndex[s->getId()]];
+}
+
+Nodes LazyDistanceOracle::getPath(Node* s, Node* g) {
+  Nodes path;
+  const std::vector<int>& d = getTable(localIndex[g->getId()]);
+  int v = localIndex[s->getId()];
+  if (d[v] == INF) return path;
+
+  // follow the distance gradient towards the goal
+  path.push_back(s);
+  while (d[v] > 0) {
+    for (int k = fwdOffsets[v]; k < fwdOffsets[v + 1]; ++k) {
+      if (d[fwdEdges[k]] == d[v] - 1) {
+        v = fwdEdges[k];
+        break;
+      }
+    }
+    path.push_back(localNodes[v]);
+  }
+  return path;
+}
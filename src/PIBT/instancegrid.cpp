@@ -0,0 +1,52 @@
+/*
+ * instancegrid.cpp
+ *
+ * Purpose: grid graph built from an in-memory Instance
+ */
+
+#include "instancegrid.h"
+
+InstanceGrid::InstanceGrid(const Instance& instance)
+  : cells(instance.map_size, nullptr)
+{
+  setSize(instance.num_of_cols, instance.num_of_rows);
+
+  for (int loc = 0; loc < instance.map_size; ++loc) {
+    if (instance.isObstacle(loc)) continue;
+    Node* v = new Node(loc);
+    v->setPos(instance.getRowCoordinate(loc), instance.getColCoordinate(loc));
+    nodes.push_back(v);
+    cells[loc] = v;
+  }
+
+  // same neighbor order as SimpleGrid::createEdges, which PIBT's tie-breaking depends on
+  int w = getW();
+  Nodes neighbor;
+  for (auto v : nodes) {
+    int id = v->getId();
+    int col = id % w;
+    neighbor.clear();
+    if (id - w >= 0 && cells[id - w]) neighbor.push_back(cells[id - w]);
+    if (col != 0 && cells[id - 1]) neighbor.push_back(cells[id - 1]);
+    if (col != w - 1 && cells[id + 1]) neighbor.push_back(cells[id + 1]);
+    if (id + w < (int)cells.size() && cells[id + w]) neighbor.push_back(cells[id + w]);
+    v->setNeighbor(neighbor);
+  }
+
+  // all nodes are target
+  starts = nodes;
+  goals = nodes;
+}
+
+InstanceGrid::~InstanceGrid() {}
+
+void InstanceGrid::reset() {
+  for (auto p : knownPaths) delete p.second;
+  knownPaths.clear();
+}
+
+std::string InstanceGrid::logStr() {
+  std::string str = Grid::logStr();
+  str += "[graph] instance grid\n";
+  return str;
+}
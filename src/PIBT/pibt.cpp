@@ -61,7 +61,6 @@ bool PIBT::solve() {
 void PIBT::allocate() {
   if (P->allocated()) return;
   auto T = P->getT();
-  Graph* _G = G;
 
   for (auto a : A) {
     if (a->hasTask()) continue;
@@ -70,9 +69,9 @@ void PIBT::allocate() {
     } else {
       auto v = a->getNode();
       auto itr = std::min_element(T.begin(), T.end(),
-                                  [v, _G] (Task* t1, Task* t2) {
-                                    return _G->dist(t1->getG()[0], v)
-                                      < _G->dist(t2->getG()[0], v);
+                                  [v, this] (Task* t1, Task* t2) {
+                                    return pathDist(v, t1->getG()[0])
+                                      < pathDist(v, t2->getG()[0]);
                                   });
       a->setGoal((*itr)->getG()[0]);
     }
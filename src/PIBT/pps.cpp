@@ -366,7 +366,11 @@ void PPS::ADD_DONE_SWAPERS(S* s) {
   }
 }
 
+// The path shape matters to push and swap (following an arbitrary shortest
+// path livelocks), so paths still come from the graph's A*; the oracle only
+// rules out unreachable goals before the exhaustive search.
 Nodes PPS::SHORTEST_PATH(Node* s, Node* g) {
+  if (getDistanceOracle()->dist(s, g) >= DistanceOracle::INF) return {};
   return G->getPath(s, g);
 }
 
@@ -375,7 +379,7 @@ Nodes PPS::SHORTEST_PATH(Node* s, Node* g, Nodes prohibited) {
 }
 
 Nodes PPS::SHORTEST_PATH(PIBT_Agent* c, Node* g) {
-  if (H.empty()) return G->getPath(c->getNode(), g);
+  if (H.empty()) return SHORTEST_PATH(c->getNode(), g);
 
   Nodes prohibited;
   for (auto a : H) prohibited.push_back(a->getNode());
@@ -598,12 +602,11 @@ bool PPS::DEPEND(Nodes piA, Nodes piB) {
 
 Nodes PPS::getSortedEsv(PIBT_Agent* c) {
   Nodes lst = deg3nodes;
-  Graph* _G = G;
   Node* v = c->getNode();
-  // actually, should use pathDist, but for fast implementation
+  // distances to v, so that one table of the oracle serves all candidates (the graph is undirected)
   std::sort(lst.begin(), lst.end(),
-            [_G, v] (Node* v1, Node* v2)
-            { return _G->dist(v, v1) < _G->dist(v, v2); });
+            [this, v] (Node* v1, Node* v2)
+            { return pathDist(v1, v) < pathDist(v2, v); });
   return lst;
 }
 
@@ -20,13 +20,24 @@ Solver::Solver(Problem* _P, std::mt19937* _MT) : P(_P), MT(_MT) {
   init();
 }
 
-Solver::~Solver() {}
+Solver::~Solver() {
+  delete D;
+}
 
 void Solver::init() {
   G = P->getG();
   A = P->getA();
-  int nodeNum = G->getNodesNum();
-  dists = Eigen::MatrixXi::Zero(nodeNum, nodeNum);
+  D = nullptr;  // built on first use unless setDistanceOracle provides one
+}
+
+void Solver::setDistanceOracle(DistanceOracle* _D) {
+  delete D;
+  D = _D;
+}
+
+DistanceOracle* Solver::getDistanceOracle() {
+  if (D == nullptr) D = new LazyDistanceOracle(G, LazyDistanceOracle::DEFAULT_BUDGET);
+  return D;
 }
 
 void Solver::solveStart() {
@@ -81,33 +92,6 @@ void Solver::solveEnd() {
   }
 }
 
-void Solver::WarshallFloyd() {
-  int nodeNum = G->getNodesNum();
-  Nodes neighbor;
-  int INF = 100000;
-  dists = Eigen::MatrixXi::Ones(nodeNum, nodeNum) * INF;
-
-  // initialize weight
-  for (int i = 0; i < nodeNum; ++i) {
-    neighbor = G->neighbor(G->getNodeFromIndex(i));
-    for (auto v : neighbor) {
-      dists(i, v->getIndex()) = 1;
-    }
-    dists(i, i) = 0;
-  }
-
-  // main loop
-  for (int k = 0; k < nodeNum; ++k) {
-    for (int i = 0; i < nodeNum; ++i) {
-      for (int j = 0; j < nodeNum; ++j) {
-        if (dists(i, j) > dists(i, k) + dists(k, j)) {
-          dists(i, j) = dists(i, k) + dists(k, j);
-        }
-      }
-    }
-  }
-}
-
 int Solver::getMaxLengthPaths(Paths& paths) {
   if (paths.empty()) return 0;
   auto itr = std::max_element(paths.begin(), paths.end(),
@@ -126,43 +110,7 @@ void Solver::formalizePath(Paths& paths) {
 }
 
 int Solver::pathDist(Node* s, Node* g) {
-  // same place?
-  if (s == g) return 0;
-
-  // has already explored?
-  int s_index = G->getNodeIndex(s);
-  int g_index = G->getNodeIndex(g);
-  int dist = dists(s_index, g_index);
-  if (dist != 0) return dist;
-
-  // new
-  Nodes path = G->getPath(s, g);
-
-  dist = path.size() - 1;  // without start node
-  int index, d, cost;
-  bool directed = G->isDirected();
-
-  cost = dist;
-  for (auto v : path) {
-    index = G->getNodeIndex(v);
-    d = dists(index, g_index);
-    if ((index != g_index) && (d == 0)) {
-      dists(index, g_index) = cost;
-      // if not directed graph
-      if (!directed) dists(g_index, index) = cost;
-      --cost;
-    } else if (d == cost) {
-      break;
-    } else {
-      std::cout << "error@Solver::pathDist, "
-                << s->getId() << " -> " << g->getId() << ", "
-                << s->getPos() << " -> " << g->getPos() << ", "
-                << "not optimal path is obtained" << "\n";
-      std::exit(1);
-    }
-  }
-
-  return dist;
+  return getDistanceOracle()->dist(s, g);
 }
 
 int Solver::pathDist(Node* s, Node* g, Nodes &prohibited) {
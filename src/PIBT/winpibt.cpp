@@ -97,8 +97,6 @@ bool winPIBT::solve() {
 void winPIBT::allocate() {
   if (P->allocated()) return;
   auto T = P->getT();
-  Graph* _G = G;
-
   for (auto a : A) {
     if (a->hasTask()) continue;
     if (T.empty()) {
@@ -106,9 +104,9 @@ void winPIBT::allocate() {
     } else {
       auto v = a->getNode();
       auto itr = std::min_element(T.begin(), T.end(),
-                                  [v, _G] (Task* t1, Task* t2) {
-                                    return _G->dist(t1->getG()[0], v)
-                                      < _G->dist(t2->getG()[0], v);
+                                  [v, this] (Task* t1, Task* t2) {
+                                    return pathDist(v, t1->getG()[0])
+                                      < pathDist(v, t2->getG()[0]);
                                   });
       a->setGoal((*itr)->getG()[0]);
     }
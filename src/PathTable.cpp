@@ -1,52 +1,167 @@
 #include "PathTable.h"
 
+PathTable::Layout PathTable::default_layout = PathTable::LOCATION_MAJOR;
+
+int& PathTable::at(int location, int t)
+{
+    if (layout == TIME_MAJOR)
+    {
+        size_t chunk = (size_t) t / CHUNK_TIMESTEPS;
+        if (table.size() <= chunk)
+            table.resize(chunk + 1, vector<int>(goals.size() * CHUNK_TIMESTEPS, NO_AGENT));
+        return table[chunk][location * CHUNK_TIMESTEPS + t % CHUNK_TIMESTEPS];
+    }
+    if (table[location].size() <= t)
+        table[location].resize(t + 1, NO_AGENT);
+    return table[location][t];
+}
+
+// store agent_id at location for the wait run [t_min, t_max)
+void PathTable::insertRun(int location, int t_min, int t_max, int agent_id)
+{
+    if (layout == SPARSE)
+    {
+        auto& location_runs = runs[location];
+        auto it = std::upper_bound(location_runs.begin(), location_runs.end(), t_min,
+                                   [](int t, const Run& run) { return t < run.t_min; });
+        location_runs.insert(it, Run{t_min, t_max, agent_id});
+    }
+    else if (layout == LOCATION_MAJOR)
+    {
+        auto& agents = table[location];
+        if ((int) agents.size() < t_max)
+            agents.resize(t_max, NO_AGENT);
+        std::fill(agents.begin() + t_min, agents.begin() + t_max, agent_id);
+    }
+    else
+    {
+        for (int t = t_min; t < t_max; t++)
+            at(location, t) = agent_id;
+    }
+    reserve(location, t_min, t_max);
+}
+
+void PathTable::deleteRun(int location, int t_min, int t_max, int agent_id)
+{
+    if (layout == SPARSE)
+    {
+        auto& location_runs = runs[location];
+        auto it = std::lower_bound(location_runs.begin(), location_runs.end(), t_min,
+                                   [](const Run& run, int t) { return run.t_min < t; });
+        while (it->agent != agent_id) // runs of colliding paths may start at the same timestep
+            ++it;
+        assert(it->t_min == t_min);
+        location_runs.erase(it);
+    }
+    else
+    {
+        for (int t = t_min; t < t_max; t++)
+        {
+            assert(getAgent(location, t) == agent_id);
+            at(location, t) = NO_AGENT;
+        }
+    }
+    unreserve(location, t_min, t_max);
+}
+
 void PathTable::insertPath(int agent_id, const Path& path)
 {
     if (path.empty())
         return;
-    for (int t = 0; t < (int)path.size(); t++)
+    for (int t = 0; t < (int)path.size();) // the wait runs of the path
     {
-        if (table[path[t].location].size() <= t)
-            table[path[t].location].resize(t + 1, NO_AGENT);
-        // assert(table[path[t].location][t] == NO_AGENT);
-        table[path[t].location][t] = agent_id;
+        int t_max = t + 1;
+        while (t_max < (int)path.size() and path[t_max].location == path[t].location)
+            t_max++;
+        insertRun(path[t].location, t, t_max, agent_id);
+        t = t_max;
     }
     assert(goals[path.back().location] == MAX_TIMESTEP);
     goals[path.back().location] = (int) path.size() - 1;
-    makespan = max(makespan, (int) path.size() - 1);
+    goal_times.insert((int) path.size() - 1);
+    makespan = *goal_times.rbegin();
 }
 
 void PathTable::deletePath(int agent_id, const Path& path)
 {
     if (path.empty())
         return;
-    for (int t = 0; t < (int)path.size(); t++)
+    for (int t = 0; t < (int)path.size();)
     {
-        assert(table[path[t].location].size() > t && table[path[t].location][t] == agent_id);
-        table[path[t].location][t] = NO_AGENT;
+        int t_max = t + 1;
+        while (t_max < (int)path.size() and path[t_max].location == path[t].location)
+            t_max++;
+        deleteRun(path[t].location, t, t_max, agent_id);
+        t = t_max;
     }
     goals[path.back().location] = MAX_TIMESTEP;
-    if (makespan == (int) path.size() - 1) // re-compute makespan
+    goal_times.erase(goal_times.find((int) path.size() - 1));
+    makespan = goal_times.empty() ? 0 : *goal_times.rbegin();
+}
+
+// add [t_min, t_max) to the reservations of location, merging it with the intervals it touches
+void PathTable::reserve(int location, int t_min, int t_max)
+{
+    auto& intervals = reservations[location];
+    auto it = std::lower_bound(intervals.begin(), intervals.end(), t_min,
+                               [](const pair<int, int>& interval, int t) { return interval.second < t; });
+    if (it == intervals.end() or t_max < it->first)
+    {
+        intervals.emplace(it, t_min, t_max);
+        return;
+    }
+    it->first = min(it->first, t_min);
+    it->second = max(it->second, t_max);
+    auto last = std::next(it);
+    while (last != intervals.end() and last->first <= it->second)
     {
-        makespan = 0;
-        for (int time : goals)
+        it->second = max(it->second, last->second);
+        ++last;
+    }
+    intervals.erase(std::next(it), last);
+}
+
+// remove [t_min, t_max) from the reservations of location, which is only correct for collision-free paths,
+// as the reservations do not record which paths overlap
+void PathTable::unreserve(int location, int t_min, int t_max)
+{
+    auto& intervals = reservations[location];
+    auto it = std::lower_bound(intervals.begin(), intervals.end(), t_min,
+                               [](const pair<int, int>& interval, int t) { return interval.second <= t; });
+    assert(it != intervals.end() and it->first <= t_min and t_max <= it->second);
+    while (it != intervals.end() and it->first < t_max)
+    {
+        if (it->first < t_min)
+        {
+            if (t_max < it->second) // split the interval
+            {
+                auto high = make_pair(t_max, it->second);
+                it->second = t_min;
+                intervals.insert(std::next(it), high);
+                return;
+            }
+            it->second = t_min;
+            ++it;
+        }
+        else if (t_max < it->second)
         {
-            if (time < MAX_TIMESTEP && time > makespan)
-                makespan = time;
+            it->first = t_max;
+            return;
         }
-
+        else
+            it = intervals.erase(it);
     }
 }
 
 bool PathTable::constrained(int from, int to, int to_time) const
 {
-    if (!table.empty())
+    if (!empty())
     {
-        if (table[to].size() > to_time && table[to][to_time] != NO_AGENT)
-            return true;  // vertex conflict with agent table[to][to_time]
-        else if (table[to].size() >= to_time && table[from].size() > to_time && !table[to].empty() &&
-                 table[to][to_time - 1] != NO_AGENT && table[from][to_time] == table[to][to_time - 1])
-            return true;  // edge conflict with agent table[to][to_time - 1]
+        if (getAgent(to, to_time) != NO_AGENT)
+            return true;  // vertex conflict with agent getAgent(to, to_time)
+        int agent = getAgent(to, to_time - 1);
+        if (agent != NO_AGENT && getAgent(from, to_time) == agent)
+            return true;  // edge conflict with agent getAgent(to, to_time - 1)
     }
     if (!goals.empty())
     {
@@ -58,13 +173,13 @@ bool PathTable::constrained(int from, int to, int to_time) const
 
 void PathTable::getConflictingAgents(int agent_id, set<int>& conflicting_agents, int from, int to, int to_time) const
 {
-    if (table.empty())
+    if (empty())
         return;
-    if (table[to].size() > to_time && table[to][to_time] != NO_AGENT)
-        conflicting_agents.insert(table[to][to_time]); // vertex conflict
-    if (table[to].size() >= to_time && table[from].size() > to_time &&
-        table[to][to_time - 1] != NO_AGENT && table[from][to_time] == table[to][to_time - 1])
-        conflicting_agents.insert(table[from][to_time]); // edge conflict
+    if (getAgent(to, to_time) != NO_AGENT)
+        conflicting_agents.insert(getAgent(to, to_time)); // vertex conflict
+    int agent = getAgent(to, to_time - 1);
+    if (agent != NO_AGENT && getAgent(from, to_time) == agent)
+        conflicting_agents.insert(agent); // edge conflict
     // TODO: collect target conflicts as well.
 }
 
@@ -72,8 +187,9 @@ void PathTable::get_agents(set<int>& conflicting_agents, int loc) const
 {
     if (loc < 0)
         return;
-    for (auto agent : table[loc])
+    for (int t = 0; t < getHorizon(loc); t++)
     {
+        int agent = getAgent(loc, t);
         if (agent >= 0)
             conflicting_agents.insert(agent);
     }
@@ -81,28 +197,28 @@ void PathTable::get_agents(set<int>& conflicting_agents, int loc) const
 
 void PathTable::get_agents(set<int>& conflicting_agents, int neighbor_size, int loc) const
 {
-    if (loc < 0 || table[loc].empty())
+    if (loc < 0 || getHorizon(loc) == 0)
         return;
-    int t_max = (int) table[loc].size() - 1;
-    while (table[loc][t_max] == NO_AGENT && t_max > 0)
+    int t_max = getHorizon(loc) - 1;
+    while (getAgent(loc, t_max) == NO_AGENT && t_max > 0)
         t_max--;
     if (t_max == 0)
         return;
     int t0 = rand() % t_max;
-    if (table[loc][t0] != NO_AGENT)
-        conflicting_agents.insert(table[loc][t0]);
+    if (getAgent(loc, t0) != NO_AGENT)
+        conflicting_agents.insert(getAgent(loc, t0));
     int delta = 1;
     while (t0 - delta >= 0 || t0 + delta <= t_max)
     {
-        if (t0 - delta >= 0 && table[loc][t0 - delta] != NO_AGENT)
+        if (t0 - delta >= 0 && getAgent(loc, t0 - delta) != NO_AGENT)
         {
-            conflicting_agents.insert(table[loc][t0 - delta]);
+            conflicting_agents.insert(getAgent(loc, t0 - delta));
             if((int) conflicting_agents.size() == neighbor_size)
                 return;
         }
-        if (t0 + delta <= t_max && table[loc][t0 + delta] != NO_AGENT)
+        if (t0 + delta <= t_max && getAgent(loc, t0 + delta) != NO_AGENT)
         {
-            conflicting_agents.insert(table[loc][t0 + delta]);
+            conflicting_agents.insert(getAgent(loc, t0 + delta));
             if((int) conflicting_agents.size() == neighbor_size)
                 return;
         }
@@ -113,12 +229,9 @@ void PathTable::get_agents(set<int>& conflicting_agents, int neighbor_size, int
 // get the holding time after the earliest_timestep for a location
 int PathTable::getHoldingTime(int location, int earliest_timestep = 0) const
 {
-    if (table.empty() or (int) table[location].size() <= earliest_timestep)
+    if (empty() or reservations[location].empty())
         return earliest_timestep;
-    int rst = (int) table[location].size();
-    while (rst > earliest_timestep and table[location][rst - 1] == NO_AGENT)
-        rst--;
-    return rst;
+    return max(earliest_timestep, reservations[location].back().second); // the timestep after the last occupied one
 }
 
 void PathTableWC::insertPath(int agent_id, const Path& path)
@@ -128,13 +241,22 @@ void PathTableWC::insertPath(int agent_id, const Path& path)
         return;
     for (int t = 0; t < (int)path.size(); t++)
     {
-        if (table[path[t].location].size() <= t)
-            table[path[t].location].resize(t + 1);
-        table[path[t].location][t].push_back(agent_id);
+        auto& agents = table[path[t].location];
+        if (agents.size() <= t)
+            agents.resize(t + 1);
+        agents[t].push_back(agent_id);
+        if (agents[t].size() == 1)
+        {
+            occupied[path[t].location].set(t);
+            last_timesteps[path[t].location] = max(last_timesteps[path[t].location], t);
+        }
+        else if (agents[t].size() == 2)
+            crowded[path[t].location].set(t);
     }
     assert(goals[path.back().location] == MAX_TIMESTEP);
     goals[path.back().location] = (int) path.size() - 1;
-    makespan = max(makespan, (int) path.size() - 1);
+    goal_times.insert((int) path.size() - 1);
+    makespan = *goal_times.rbegin();
 }
 void PathTableWC::insertPath(int agent_id)
 {
@@ -148,33 +270,30 @@ void PathTableWC::deletePath(int agent_id)
         return;
     for (int t = 0; t < (int)path.size(); t++)
     {
-        assert(table[path[t].location].size() > t &&
-               std::find (table[path[t].location][t].begin(), table[path[t].location][t].end(), agent_id)
-               != table[path[t].location][t].end());
-        table[path[t].location][t].remove(agent_id);
-    }
-    goals[path.back().location] = MAX_TIMESTEP;
-    if (makespan == (int) path.size() - 1) // re-compute makespan
-    {
-        makespan = 0;
-        for (int time : goals)
+        assert(table[path[t].location].size() > t && table[path[t].location][t].contains(agent_id));
+        auto& agents = table[path[t].location][t];
+        agents.remove(agent_id);
+        if (agents.empty())
         {
-            if (time < MAX_TIMESTEP && time > makespan)
-                makespan = time;
+            occupied[path[t].location].reset(t);
+            if (last_timesteps[path[t].location] == t)
+                last_timesteps[path[t].location] = occupied[path[t].location].last();
         }
-
+        else if (agents.size() == 1)
+            crowded[path[t].location].reset(t);
     }
+    goals[path.back().location] = MAX_TIMESTEP;
+    goal_times.erase(goal_times.find((int) path.size() - 1));
+    makespan = goal_times.empty() ? 0 : *goal_times.rbegin();
 }
 
 int PathTableWC::getFutureNumOfCollisions(int loc, int time) const
 {
     assert(goals[loc] == MAX_TIMESTEP);
-    int rst = 0;
-    if (!table.empty() && (int)table[loc].size() > time)
-    {
-        for (int t = time + 1; t < (int)table[loc].size(); t++)
-            rst += (int)table[loc][t].size();  // vertex conflict
-    }
+    if (table.empty())
+        return 0;
+    int rst = occupied[loc].count(time + 1); // vertex conflicts, plus the extra agents of the crowded timesteps
+    crowded[loc].visit(time + 1, [&](int t) { rst += (int)table[loc][t].size() - 1; });
     return rst;
 }
 
@@ -189,11 +308,8 @@ int PathTableWC::getNumOfCollisions(int from, int to, int to_time) const
         {
             for (auto a1 : table[to][to_time - 1])
             {
-                for (auto a2: table[from][to_time])
-                {
-                    if (a1 == a2)
-                        rst++; // edge conflict
-                }
+                if (table[from][to_time].contains(a1))
+                    rst++; // edge conflict
             }
         }
     }
@@ -214,11 +330,8 @@ bool PathTableWC::hasCollisions(int from, int to, int to_time) const
         {
             for (auto a1 : table[to][to_time - 1])
             {
-                for (auto a2: table[from][to_time])
-                {
-                    if (a1 == a2)
-                        return true; // edge conflict
-                }
+                if (table[from][to_time].contains(a1))
+                    return true; // edge conflict
             }
         }
     }
@@ -235,11 +348,8 @@ bool PathTableWC::hasEdgeCollisions(int from, int to, int to_time) const
     {
         for (auto a1 : table[to][to_time - 1])
         {
-            for (auto a2: table[from][to_time])
-            {
-                if (a1 == a2)
-                    return true; // edge conflict
-            }
+            if (table[from][to_time].contains(a1))
+                return true; // edge conflict
         }
     }
     return false;
@@ -264,17 +374,16 @@ int PathTableWC::getLastCollisionTimestep(int location) const
 {
     if (table.empty())
         return -1;
-    for (int t = (int)table[location].size() - 1; t >= 0; t--)
-    {
-        if (!table[location][t].empty())
-            return t;
-    }
-    return -1;
+    return last_timesteps[location];
 }
 
 void PathTableWC::clear()
 {
     table.clear();
+    occupied.clear();
+    crowded.clear();
+    last_timesteps.clear();
     goals.clear();
+    goal_times.clear();
     paths.clear();
 }
\ No newline at end of file
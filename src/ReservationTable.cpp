@@ -1,5 +1,25 @@
 #include "ReservationTable.h"
 
+thread_local ReservationTable::Storage ReservationTable::storage;
+
+ReservationTable::ReservationTable(const ConstraintTable& constraint_table, int goal_location) :
+    constraint_table(constraint_table), goal_location(goal_location), sit(storage.sit), intervals(storage.intervals),
+    location_intervals(storage.location_intervals), remaining_intervals(storage.remaining_intervals)
+{
+    assert(!storage.in_use);
+    storage.in_use = true;
+    if (sit.size() != constraint_table.map_size)
+        sit.assign(constraint_table.map_size, {-1, -1});
+    intervals.clear();
+}
+
+ReservationTable::~ReservationTable()
+{
+    for (auto location : storage.built_locations)
+        sit[location] = {-1, -1};
+    storage.built_locations.clear();
+    storage.in_use = false;
+}
 
 /*int ResevationTable::get_holding_time(int location)
 { 
@@ -28,118 +48,155 @@
 }*/
 
 
-void ReservationTable::insert2SIT(int location, int t_min, int t_max)
+// the intervals of location are built in location_intervals and stored into intervals by updateSIT
+void ReservationTable::insert2SIT(int t_min, int t_max)
 {
-	assert(t_min >= 0 and t_min < t_max and !sit[location].empty());
-    for (auto it = sit[location].begin(); it != sit[location].end();)
+    auto& sit_location = location_intervals;
+	assert(t_min >= 0 and t_min < t_max and !sit_location.empty());
+    for (size_t i = 0; i < sit_location.size();)
     {
-        if (t_min >= get<1>(*it))
-			++it; 
-        else if (t_max <= get<0>(*it))
+        auto i_min = get<0>(sit_location[i]);
+        auto i_max = get<1>(sit_location[i]);
+        auto has_collision = get<2>(sit_location[i]);
+        if (t_min >= i_max)
+			++i;
+        else if (t_max <= i_min)
             break;
-        else if (get<0>(*it) < t_min && get<1>(*it) <= t_max)
+        else if (i_min < t_min && i_max <= t_max)
         {
-            (*it) = make_tuple(get<0>(*it), t_min, get<2>(*it));
-			++it;
+            sit_location[i] = make_tuple(i_min, t_min, has_collision);
+			++i;
         }
-        else if (t_min <= get<0>(*it) && t_max < get<1>(*it))
+        else if (t_min <= i_min && t_max < i_max)
         {
-            (*it) = make_tuple(t_max, get<1>(*it), get<2>(*it));
+            sit_location[i] = make_tuple(t_max, i_max, has_collision);
             break;
         }
-        else if (get<0>(*it) < t_min && t_max < get<1>(*it))
+        else if (i_min < t_min && t_max < i_max)
         {
-            sit[location].insert(it, make_tuple(get<0>(*it), t_min, get<2>(*it)));
-            (*it) = make_tuple(t_max, get<1>(*it), get<2>(*it));
+            sit_location.insert(sit_location.begin() + i, make_tuple(i_min, t_min, has_collision));
+            sit_location[i + 1] = make_tuple(t_max, i_max, has_collision);
             break;
         }
         else // constraint_min <= get<0>(*it) && get<1> <= constraint_max
         {
-            it = sit[location].erase(it);
+            sit_location.erase(sit_location.begin() + i);
+        }
+    }
+}
+
+// remove the sorted, disjoint reservations from location_intervals in one pass over both
+void ReservationTable::removeReservationsFromSIT(const vector< pair<int, int> >& reservations)
+{
+    if (reservations.empty())
+        return;
+    auto& sit_location = location_intervals;
+    remaining_intervals.clear();
+    auto r = reservations.begin();
+    for (const auto& interval : sit_location)
+    {
+        auto t = get<0>(interval);
+        auto t_max = get<1>(interval);
+        while (r != reservations.end() and r->second <= t)
+            ++r;
+        for (auto it = r; it != reservations.end() and it->first < t_max; ++it)
+        {
+            if (t < it->first)
+                remaining_intervals.emplace_back(t, it->first, get<2>(interval));
+            t = max(t, it->second);
         }
+        if (t < t_max)
+            remaining_intervals.emplace_back(t, t_max, get<2>(interval));
     }
+    sit_location.swap(remaining_intervals);
 }
 
 void ReservationTable::insertSoftConstraint2SIT(int location, int t_min, int t_max)
 {
-    assert(t_min >= 0 && t_min < t_max and !sit[location].empty());
-    for (auto it = sit[location].begin(); it != sit[location].end(); ++it)
+    auto& sit_location = location_intervals;
+    assert(t_min >= 0 && t_min < t_max and !sit_location.empty());
+    // we can merge the i-th interval with the next one
+    auto mergeable_with_next = [&](size_t i, int i_max)
     {
-        if (t_min >= get<1>(*it) || get<2>(*it))
+        return i + 1 < sit_location.size() and (location != goal_location || i_max != constraint_table.length_min) and
+               i_max == get<0>(sit_location[i + 1]) and get<2>(sit_location[i + 1]);
+    };
+    // we can merge the i-th interval with the previous one
+    auto mergeable_with_prev = [&](size_t i, int i_min)
+    {
+        return i > 0 and (location != goal_location || i_min != constraint_table.length_min) and
+               i_min == get<1>(sit_location[i - 1]) and get<2>(sit_location[i - 1]);
+    };
+    for (size_t i = 0; i < sit_location.size(); ++i)
+    {
+        if (t_min >= get<1>(sit_location[i]) || get<2>(sit_location[i]))
             continue;
-        else if (t_max <= get<0>(*it))
+        else if (t_max <= get<0>(sit_location[i]))
             break;
 
-        auto i_min = get<0>(*it);
-        auto i_max = get<1>(*it);
+        auto i_min = get<0>(sit_location[i]);
+        auto i_max = get<1>(sit_location[i]);
         if (i_min < t_min && i_max <= t_max)
         {
-            if (it != sit[location].end() and std::next(it) != sit[location].end() and
-                    (location != goal_location || i_max != constraint_table.length_min) and
-                    i_max == get<0>(*std::next(it)) and get<2>(*std::next(it))) // we can merge the current interval with the next one
+            if (mergeable_with_next(i, i_max))
             {
-                (*it) = make_tuple(i_min, t_min, false);
-                ++it;
-                (*it) = make_tuple(t_min, get<1>(*it), true);
+                sit_location[i] = make_tuple(i_min, t_min, false);
+                ++i;
+                sit_location[i] = make_tuple(t_min, get<1>(sit_location[i]), true);
             }
             else
             {
-                sit[location].insert(it, make_tuple(i_min, t_min, false));
-                (*it) = make_tuple(t_min, i_max, true);
+                sit_location.insert(sit_location.begin() + i, make_tuple(i_min, t_min, false));
+                ++i;
+                sit_location[i] = make_tuple(t_min, i_max, true);
             }
 
         }
         else if (t_min <= i_min && t_max < i_max)
         {
-            if (it != sit[location].begin() and (location != goal_location || i_min != constraint_table.length_min) and
-                    i_min == get<1>(*std::prev(it)) and get<2>(*std::prev(it))) // we can merge the current interval with the previous one
+            if (mergeable_with_prev(i, i_min))
             {
-                (*std::prev(it)) = make_tuple(get<0>(*std::prev(it)), t_max, true);
+                sit_location[i - 1] = make_tuple(get<0>(sit_location[i - 1]), t_max, true);
             }
             else
             {
-                sit[location].insert(it, make_tuple(i_min, t_max, true));
+                sit_location.insert(sit_location.begin() + i, make_tuple(i_min, t_max, true));
+                ++i;
             }
-            (*it) = make_tuple(t_max, i_max, false);
+            sit_location[i] = make_tuple(t_max, i_max, false);
         }
         else if (i_min < t_min && t_max < i_max)
         {
-            sit[location].insert(it, make_tuple(i_min, t_min, false));
-            sit[location].insert(it, make_tuple(t_min, t_max, true));
-            (*it) = make_tuple(t_max, i_max, false);
+            sit_location.insert(sit_location.begin() + i, {make_tuple(i_min, t_min, false), make_tuple(t_min, t_max, true)});
+            i += 2;
+            sit_location[i] = make_tuple(t_max, i_max, false);
         }
         else // constraint_min <= get<0>(*it) && get<1> <= constraint_max
         {
-            if (it != sit[location].begin() and (location != goal_location || i_min != constraint_table.length_min) and
-                i_min == get<1>(*std::prev(it)) and get<2>(*std::prev(it))) // we can merge the current interval with the previous one
+            if (mergeable_with_prev(i, i_min))
             {
-                if (it != sit[location].end() and std::next(it) != sit[location].end() and
-                        (location != goal_location || i_max != constraint_table.length_min) and
-                        i_max == get<0>(*std::next(it)) and get<2>(*std::next(it))) // we can merge the current interval with the next one
+                if (mergeable_with_next(i, i_max))
                 {
-                    (*std::prev(it)) = make_tuple(get<0>(*std::prev(it)), get<1>(*std::next(it)), true);
-                    sit[location].erase(std::next(it));
-                    it = sit[location].erase(it);
+                    sit_location[i - 1] = make_tuple(get<0>(sit_location[i - 1]), get<1>(sit_location[i + 1]), true);
+                    sit_location.erase(sit_location.begin() + i, sit_location.begin() + i + 2);
                 }
                 else
                 {
-                    (*std::prev(it)) = make_tuple(get<0>(*std::prev(it)), i_max, true);
-                    it = sit[location].erase(it);
+                    sit_location[i - 1] = make_tuple(get<0>(sit_location[i - 1]), i_max, true);
+                    sit_location.erase(sit_location.begin() + i);
                 }
-                --it;
+                --i;
             }
             else
             {
-                if (it != sit[location].end() and std::next(it) != sit[location].end() and
-                        (location != goal_location || i_max != constraint_table.length_min) and
-                        i_max == get<0>(*std::next(it)) and get<2>(*std::next(it))) // we can merge the current interval with the next one
+                if (mergeable_with_next(i, i_max))
                 {
-                    (*it) = make_tuple(i_min, get<1>(*std::next(it)), true);
-                    sit[location].erase(std::next(it));
+                    sit_location[i] = make_tuple(i_min, get<1>(sit_location[i + 1]), true);
+                    sit_location.erase(sit_location.begin() + i + 1);
                 }
                 else
                 {
-                    (*it) = make_tuple(i_min, i_max, true);
+                    sit_location[i] = make_tuple(i_min, i_max, true);
                 }
             }
         }
@@ -174,40 +231,38 @@ void ReservationTable::insertSoftConstraint2SIT(int location, int t_min, int t_m
 // update SIT at the given location
 void ReservationTable::updateSIT(int location)
 {
-    assert(sit[location].empty());
+    assert(sit[location].first < 0);
+    storage.built_locations.push_back(location);
+    auto& sit_location = location_intervals;
+    sit_location.clear();
     // length constraints for the goal location
     if (location == goal_location) // we need to divide the same intervals into 2 parts [0, length_min) and [length_min, length_max + 1)
     {
         if (constraint_table.length_min > constraint_table.length_max) // the location is blocked for the entire time horizon
         {
-            sit[location].emplace_back(0, 0, false);
+            sit[location] = make_pair((int)intervals.size(), (int)intervals.size() + 1);
+            intervals.emplace_back(0, 0, false);
             return;
         }
         if (0 < constraint_table.length_min)
         {
-            sit[location].emplace_back(0, constraint_table.length_min, false);
+            sit_location.emplace_back(0, constraint_table.length_min, false);
         }
         assert(constraint_table.length_min >= 0);
-        sit[location].emplace_back(constraint_table.length_min, min(constraint_table.length_max + 1, MAX_TIMESTEP), false);
+        sit_location.emplace_back(constraint_table.length_min, min(constraint_table.length_max + 1, MAX_TIMESTEP), false);
     }
     else
     {
-        sit[location].emplace_back(0, min(constraint_table.length_max, MAX_TIMESTEP - 1) + 1, false);
+        sit_location.emplace_back(0, min(constraint_table.length_max, MAX_TIMESTEP - 1) + 1, false);
     }
     // path table
-    if (constraint_table.path_table_for_CT != nullptr and !constraint_table.path_table_for_CT->table.empty())
+    if (constraint_table.path_table_for_CT != nullptr and !constraint_table.path_table_for_CT->empty())
     {
         if (location < constraint_table.map_size) // vertex conflict
         {
-            for (int t = 0; t < (int)constraint_table.path_table_for_CT->table[location].size(); t++)
-            {
-                if (constraint_table.path_table_for_CT->table[location][t] != NO_AGENT)
-                {
-                    insert2SIT(location, t, t+1);
-                }
-            }
+            removeReservationsFromSIT(constraint_table.path_table_for_CT->reservations[location]);
             if (constraint_table.path_table_for_CT->goals[location] < MAX_TIMESTEP) // target conflict
-                insert2SIT(location, constraint_table.path_table_for_CT->goals[location], MAX_TIMESTEP + 1);
+                insert2SIT(constraint_table.path_table_for_CT->goals[location], MAX_TIMESTEP + 1);
         }
         else // edge conflict
         {
@@ -215,15 +270,13 @@ void ReservationTable::updateSIT(int location)
             auto to = location % constraint_table.map_size;
             if (from != to)
             {
-                int t_max = (int) min(constraint_table.path_table_for_CT->table[from].size(),
-                                      constraint_table.path_table_for_CT->table[to].size() + 1);
-                for (int t = 1; t < t_max; t++)
+                for (int t = 1; t <= constraint_table.path_table_for_CT->makespan; t++)
                 {
-                    if (constraint_table.path_table_for_CT->table[to][t - 1] != NO_AGENT and
-                        constraint_table.path_table_for_CT->table[to][t - 1] ==
-                        constraint_table.path_table_for_CT->table[from][t])
+                    if (constraint_table.path_table_for_CT->getAgent(to, t - 1) != NO_AGENT and
+                        constraint_table.path_table_for_CT->getAgent(to, t - 1) ==
+                        constraint_table.path_table_for_CT->getAgent(from, t))
                     {
-                        insert2SIT(location, t, t+1);
+                        insert2SIT(t, t+1);
                     }
                 }
             }
@@ -231,12 +284,7 @@ void ReservationTable::updateSIT(int location)
     }
 
     // negative constraints
-    const auto& it = constraint_table.ct.find(location);
-    if (it != constraint_table.ct.end())
-    {
-        for (auto time_range : it->second)
-            insert2SIT(location, time_range.first, time_range.second);
-    }
+    constraint_table.ct.visit(location, [&](int t_min, int t_max) { insert2SIT(t_min, t_max); });
 
     // positive constraints
     if (location < constraint_table.map_size)
@@ -245,7 +293,7 @@ void ReservationTable::updateSIT(int location)
         {
             if (landmark.second != location)
             {
-                insert2SIT(location, landmark.first, landmark.first + 1);
+                insert2SIT(landmark.first, landmark.first + 1);
             }
         }
     }
@@ -256,13 +304,9 @@ void ReservationTable::updateSIT(int location)
     {
         if (location < constraint_table.map_size) // vertex conflict
         {
-            for (int t = 0; t < (int)constraint_table.path_table_for_CAT->table[location].size(); t++)
-            {
-                if (!constraint_table.path_table_for_CAT->table[location][t].empty())
-                {
-                    insertSoftConstraint2SIT(location, t, t+1);
-                }
-            }
+            constraint_table.path_table_for_CAT->occupied[location].visit(0, [&](int t) {
+                insertSoftConstraint2SIT(location, t, t + 1);
+            });
             if (constraint_table.path_table_for_CAT->goals[location] < MAX_TIMESTEP) // target conflict
                 insertSoftConstraint2SIT(location, constraint_table.path_table_for_CAT->goals[location], MAX_TIMESTEP + 1);
         }
@@ -299,63 +343,20 @@ void ReservationTable::updateSIT(int location)
     // soft constraints
     if (!constraint_table.cat.empty())
     {
-        for (auto t = 0; t < constraint_table.cat[location].size(); t++)
-        {
-            if (constraint_table.cat[location][t])
-                insertSoftConstraint2SIT(location, t, t + 1);
-        }
+        constraint_table.cat[location].visit(0, [&](int t) { insertSoftConstraint2SIT(location, t, t + 1); });
         if (constraint_table.cat_goals[location] < MAX_TIMESTEP)
             insertSoftConstraint2SIT(location, constraint_table.cat_goals[location], MAX_TIMESTEP + 1);
     }
-}
-
-// return <upper_bound, low, high,  vertex collision, edge collision>
-list<tuple<int, int, int, bool, bool>> ReservationTable::get_safe_intervals(int from, int to, int lower_bound, int upper_bound)
-{
-    list<tuple<int, int, int, bool, bool>> rst;
-    if (lower_bound >= upper_bound)
-        return rst;
-
-    if (sit[to].empty())
-        updateSIT(to);
 
-    for(auto interval : sit[to])
-    {
-        if (lower_bound >= get<1>(interval))
-            continue;
-        else if (upper_bound <= get<0>(interval))
-            break;
-        // the interval overlaps with [lower_bound, upper_bound)
-        auto t1 = get_earliest_arrival_time(from, to,
-                max(lower_bound, get<0>(interval)), min(upper_bound, get<1>(interval)));
-        if (t1 < 0) // the interval is not reachable
-            continue;
-        else if (get<2>(interval)) // the interval has collisions
-        {
-            rst.emplace_back(get<1>(interval), t1, get<1>(interval), true, false);
-        }
-        else // the interval does not have collisions
-        { // so we need to check the move action has collisions or not
-            auto t2 = get_earliest_no_collision_arrival_time(from, to, interval, t1, upper_bound);
-            if (t1 == t2)
-                rst.emplace_back(get<1>(interval), t1, get<1>(interval), false, false);
-            else if (t2 < 0)
-                rst.emplace_back(get<1>(interval), t1, get<1>(interval), false, true);
-            else
-            {
-                rst.emplace_back(get<1>(interval), t1, t2, false, true);
-                rst.emplace_back(get<1>(interval), t2, get<1>(interval), false, false);
-            }
-        }
-    }
-    return rst;
+    sit[location] = make_pair((int)intervals.size(), (int)(intervals.size() + sit_location.size()));
+    intervals.insert(intervals.end(), sit_location.begin(), sit_location.end());
 }
 
 Interval ReservationTable::get_first_safe_interval(size_t location)
 {
-    if (sit[location].empty())
+    if (sit[location].first < 0)
 	    updateSIT(location);
-    return sit[location].front();
+    return intervals[sit[location].first];
 }
 
 // find a safe interval with t_min as given
@@ -363,10 +364,11 @@ bool ReservationTable::find_safe_interval(Interval& interval, size_t location, i
 {
 	if (t_min >= min(constraint_table.length_max, MAX_TIMESTEP - 1) + 1)
 		return false;
-    if (sit[location].empty())
+    if (sit[location].first < 0)
 	    updateSIT(location);
-    for( auto & i : sit[location])
+    for (int k = sit[location].first; k < sit[location].second; k++)
     {
+        const auto& i = intervals[k];
         if ((int)get<0>(i) <= t_min && t_min < (int)get<1>(i))
         {
             interval = Interval(t_min, get<1>(i), get<2>(i));
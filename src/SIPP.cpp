@@ -1,5 +1,8 @@
 #include "SIPP.h"
 
+thread_local NodeArena<SIPPNode> SIPP::node_arena;
+thread_local SIPP::hashtable_t SIPP::allNodes_table;
+
 void SIPP::updatePath(const LLNode* goal, vector<PathEntry> &path)
 {
     num_collisions = goal->num_of_conflicts;
@@ -41,9 +44,12 @@ Path SIPP::findPath(const ConstraintTable& constraint_table)
     auto last_target_collision_time = constraint_table.getLastCollisionTimestep(goal_location);
     // generate start and add it to the OPEN & FOCAL list
     auto h = max(max(my_heuristic[start_location], holding_time), last_target_collision_time + 1);
-    auto start = new SIPPNode(start_location, 0, h, nullptr, 0, get<1>(interval), get<1>(interval),
+    auto start = createNode(start_location, 0, h, nullptr, 0, get<1>(interval), get<1>(interval),
                                 get<2>(interval), get<2>(interval));
     pushNodeToFocal(start);
+    auto static_timestep = constraint_table.getMaxTimestep(); // everything is static afterward
+    vector<bool> dead_ends; // locations from which followHeuristicToGoal failed
+    bool follow_heuristic = my_heuristic.isTable(); // see followHeuristicToGoal
 
     while (!focal_list.empty())
     {
@@ -69,7 +75,7 @@ Path SIPP::findPath(const ConstraintTable& constraint_table)
                 break;
             }
             // generate a goal node
-            auto goal = new SIPPNode(*curr);
+            auto goal = createNode(*curr);
             goal->is_goal = true;
             goal->h_val = 0;
             goal->num_of_conflicts += future_collisions;
@@ -77,33 +83,48 @@ Path SIPP::findPath(const ConstraintTable& constraint_table)
             if (dominanceCheck(goal))
                 pushNodeToFocal(goal);
             else
-                delete goal;
+                node_arena.release(goal);
+        }
+
+        if (follow_heuristic and curr->timestep >= static_timestep and curr->location != goal_location)
+        { // no need to expand the cells between curr and the goal location one by one
+            if (dead_ends.empty())
+                dead_ends.resize(instance.map_size, false);
+            auto goal = followHeuristicToGoal(curr, reservation_table, dead_ends);
+            if (goal != nullptr)
+            {
+                if (dominanceCheck(goal))
+                    pushNodeToFocal(goal);
+                else
+                    node_arena.release(goal);
+                continue;
+            }
         }
 
         for (int next_location : instance.getNeighbors(curr->location)) // move to neighboring locations
         {
-            for (auto & i : reservation_table.get_safe_intervals(
-                    curr->location, next_location, curr->timestep + 1, curr->high_expansion + 1))
+            reservation_table.for_each_safe_interval(
+                    curr->location, next_location, curr->timestep + 1, curr->high_expansion + 1,
+                    [&](int next_high_generation, int next_timestep, int next_high_expansion,
+                            bool next_v_collision, bool next_e_collision)
             {
-                int next_high_generation, next_timestep, next_high_expansion;
-                bool next_v_collision, next_e_collision;
-                tie(next_high_generation, next_timestep, next_high_expansion, next_v_collision, next_e_collision) = i;
                 if (next_timestep + my_heuristic[next_location] > constraint_table.length_max)
-                    break;
+                    return false;
                 auto next_collisions = curr->num_of_conflicts +
                                     // (int)curr->collision_v * max(next_timestep - curr->timestep - 1, 0) + // wait time
                                       (int)next_v_collision + (int)next_e_collision;
                 auto next_h_val = max(my_heuristic[next_location], (next_collisions > 0?
                     holding_time : curr->getFVal()) - next_timestep); // path max
                 // generate (maybe temporary) node
-                auto next = new SIPPNode(next_location, next_timestep, next_h_val, curr, next_timestep,
+                auto next = createNode(next_location, next_timestep, next_h_val, curr, next_timestep,
                                          next_high_generation, next_high_expansion, next_v_collision, next_collisions);
                 // try to retrieve it from the hash table
                 if (dominanceCheck(next))
                     pushNodeToFocal(next);
                 else
-                    delete next;
-            }
+                    node_arena.release(next);
+                return true;
+            });
         }  // end for loop that generates successors
         // wait at the current location
         if (curr->high_expansion == curr->high_generation and
@@ -115,14 +136,14 @@ Path SIPP::findPath(const ConstraintTable& constraint_table)
             auto next_collisions = curr->num_of_conflicts +
                     // (int)curr->collision_v * max(next_timestep - curr->timestep - 1, 0) +
 		    (int)get<2>(interval);
-            auto next = new SIPPNode(curr->location, next_timestep, next_h_val, curr, next_timestep,
+            auto next = createNode(curr->location, next_timestep, next_h_val, curr, next_timestep,
                                      get<1>(interval), get<1>(interval), get<2>(interval),
                                      next_collisions);
             next->wait_at_goal = (curr->location == goal_location);
             if (dominanceCheck(next))
                 pushNodeToFocal(next);
             else
-                delete next;
+                node_arena.release(next);
         }
     }  // end while loop
 
@@ -169,16 +190,19 @@ pair<Path, int> SIPP::findSuboptimalPath(const HLNode& node, const ConstraintTab
 		return {path, 0};
 
 	 // generate start and add it to the OPEN list
-	auto start = new SIPPNode(start_location, 0, max(my_heuristic[start_location], holding_time), nullptr, 0,
+	auto start = createNode(start_location, 0, max(my_heuristic[start_location], holding_time), nullptr, 0,
         get<1>(interval), get<1>(interval), get<2>(interval), get<2>(interval));
     min_f_val = max(holding_time, max((int)start->getFVal(), lowerbound));
     pushNodeToOpenAndFocal(start);
+    auto static_timestep = constraint_table.getMaxTimestep(); // everything is static afterward
+    vector<bool> dead_ends; // locations from which followHeuristicToGoal failed
+    bool follow_heuristic = my_heuristic.isTable(); // see followHeuristicToGoal
 
 	while (!open_list.empty()) 
 	{
 		updateFocalList(); // update FOCAL if min f-val increased
 		SIPPNode* curr = focal_list.top(); focal_list.pop();
-		open_list.erase(curr->open_handle);
+		open_list.erase(curr);
 		curr->in_openlist = false;
 		num_expanded++;
 
@@ -191,29 +215,44 @@ pair<Path, int> SIPP::findSuboptimalPath(const HLNode& node, const ConstraintTab
             break;
         }
 
+        if (follow_heuristic and curr->timestep >= static_timestep and curr->location != goal_location)
+        { // no need to expand the cells between curr and the goal location one by one
+            if (dead_ends.empty())
+                dead_ends.resize(instance.map_size, false);
+            auto goal = followHeuristicToGoal(curr, reservation_table, dead_ends);
+            if (goal != nullptr)
+            {
+                if (dominanceCheck(goal))
+                    pushNodeToOpenAndFocal(goal);
+                else
+                    node_arena.release(goal);
+                continue;
+            }
+        }
+
         for (int next_location : instance.getNeighbors(curr->location)) // move to neighboring locations
 		{
-			for (auto & i : reservation_table.get_safe_intervals(
-				curr->location, next_location, curr->timestep + 1, curr->high_expansion + 1))
+			reservation_table.for_each_safe_interval(
+				curr->location, next_location, curr->timestep + 1, curr->high_expansion + 1,
+				[&](int next_high_generation, int next_timestep, int next_high_expansion,
+				        bool next_v_collision, bool next_e_collision)
 			{
-			    int next_high_generation, next_timestep, next_high_expansion;
-                bool next_v_collision, next_e_collision;
-                tie(next_high_generation, next_timestep, next_high_expansion, next_v_collision, next_e_collision) = i;
                 // compute cost to next_id via curr node
                 int next_g_val = next_timestep;
                 int next_h_val = max(my_heuristic[next_location], curr->getFVal() - next_g_val);  // path max
                 if (next_g_val + next_h_val > reservation_table.constraint_table.length_max)
-                    continue;
+                    return true;
                 int next_conflicts = curr->num_of_conflicts +
                         //(int)curr->collision_v * max(next_timestep - curr->timestep - 1, 0) +
                         (int)next_v_collision + (int)next_e_collision;
-                auto next = new SIPPNode(next_location, next_g_val, next_h_val, curr, next_timestep,
+                auto next = createNode(next_location, next_g_val, next_h_val, curr, next_timestep,
                         next_high_generation, next_high_expansion, next_v_collision, next_conflicts);
                 if (dominanceCheck(next))
                     pushNodeToOpenAndFocal(next);
                 else
-                    delete next;
-			}
+                    node_arena.release(next);
+                return true;
+			});
 		}  // end for loop that generates successors
 		   
 		// wait at the current location
@@ -226,14 +265,14 @@ pair<Path, int> SIPP::findSuboptimalPath(const HLNode& node, const ConstraintTab
             auto next_collisions = curr->num_of_conflicts +
                                    //(int)curr->collision_v * max(next_timestep - curr->timestep - 1, 0) + // wait time
                                    (int)get<2>(interval);
-            auto next = new SIPPNode(curr->location, next_timestep, next_h_val, curr, next_timestep,
+            auto next = createNode(curr->location, next_timestep, next_h_val, curr, next_timestep,
                                      get<1>(interval), get<1>(interval), get<2>(interval), next_collisions);
             if (curr->location == goal_location)
                 next->wait_at_goal = true;
             if (dominanceCheck(next))
                 pushNodeToOpenAndFocal(next);
             else
-                delete next;
+                node_arena.release(next);
 		}
 	}  // end while loop
 	  
@@ -253,7 +292,7 @@ pair<Path, int> SIPP::findSuboptimalPath(const HLNode& node, const ConstraintTab
                             constraint_table.getLastCollisionTimestep(goal_location) + 1);
     // generate start and add it to the OPEN & FOCAL list
 
-    auto start = new SIPPNode(start_location, 0, max(my_heuristic[start_location], holding_time),
+    auto start = createNode(start_location, 0, max(my_heuristic[start_location], holding_time),
                               nullptr, 0, interval, 0);
     pushNodeToFocal(start);
     while (!focal_list.empty())
@@ -304,7 +343,7 @@ int SIPP::getTravelTime(int start, int end, const ConstraintTable& constraint_ta
     reset();
     min_f_val = -1; // this disables focal list
     int length = MAX_TIMESTEP;
-    auto root = new SIPPNode(start, 0, compute_heuristic(start, end), nullptr, 0, 1, 1, 0, 0);
+    auto root = createNode(start, 0, compute_heuristic(start, end), nullptr, 0, 1, 1, 0, 0);
     pushNodeToOpenAndFocal(root);
     auto static_timestep = constraint_table.getMaxTimestep(); // everything is static after this timestep
     while (!open_list.empty())
@@ -315,8 +354,7 @@ int SIPP::getTravelTime(int start, int end, const ConstraintTable& constraint_ta
             length = curr->g_val;
             break;
         }
-        list<int> next_locations = instance.getNeighbors(curr->location);
-        next_locations.emplace_back(curr->location);
+        auto next_locations = instance.getNextLocations(curr->location);
         for (int next_location : next_locations)
         {
             int next_timestep = curr->timestep + 1;
@@ -335,12 +373,12 @@ int SIPP::getTravelTime(int start, int end, const ConstraintTable& constraint_ta
                 int next_h_val = compute_heuristic(next_location, end);
                 if (next_g_val + next_h_val >= upper_bound) // the cost of the path is larger than the upper bound
                     continue;
-                auto next = new SIPPNode(next_location, next_g_val, next_h_val, nullptr, next_timestep,
+                auto next = createNode(next_location, next_g_val, next_h_val, nullptr, next_timestep,
                                          next_timestep + 1, next_timestep + 1, 0, 0);
                 if (dominanceCheck(next))
                     pushNodeToOpenAndFocal(next);
                 else
-                    delete next;
+                    node_arena.release(next);
             }
         }
     }
@@ -351,17 +389,60 @@ int SIPP::getTravelTime(int start, int end, const ConstraintTable& constraint_ta
     return length;
 }
 
+// After the static timestep of the constraint table, the safe intervals never end, so we move from curr
+// to a neighbor with a smaller heuristic at every timestep until the goal location is reached.
+// This is only tried with a precomputed distance table: the landmark heuristic rarely decreases by one
+// along a shortest path, and every probe of the lazy heuristic may resume its backward search.
+// Returns the node at the goal location, or nullptr if the walk is blocked (e.g., by the target of another
+// agent), in which case the locations on the walk are marked as dead ends.
+SIPPNode* SIPP::followHeuristicToGoal(SIPPNode* curr, ReservationTable& reservation_table, vector<bool>& dead_ends)
+{
+    const auto& constraint_table = reservation_table.constraint_table;
+    if (dead_ends[curr->location] or curr->timestep + my_heuristic[curr->location] > constraint_table.length_max)
+        return nullptr;
+    Interval interval;
+    auto prev = curr;
+    while (prev->location != goal_location)
+    {
+        int next_timestep = prev->timestep + 1;
+        int next_location = -1;
+        for (int location : instance.getNeighbors(prev->location))
+        {
+            if (my_heuristic[location] + 1 == my_heuristic[prev->location] and !dead_ends[location] and
+                reservation_table.find_safe_interval(interval, location, next_timestep) and !get<2>(interval) and
+                !constraint_table.constrained(prev->location, location, next_timestep) and
+                !constraint_table.hasEdgeConflict(prev->location, location, next_timestep))
+            {
+                next_location = location;
+                break;
+            }
+        }
+        if (next_location < 0) // the walk is blocked
+        {
+            for (const LLNode* node = prev; node != curr; node = node->parent)
+                dead_ends[node->location] = true;
+            dead_ends[curr->location] = true;
+            return nullptr;
+        }
+        auto next_h_val = max(my_heuristic[next_location], prev->getFVal() - next_timestep); // path max
+        prev = createNode(next_location, next_timestep, next_h_val, prev, next_timestep,
+                          get<1>(interval), get<1>(interval), false, prev->num_of_conflicts);
+    }
+    return prev;
+}
+
 void SIPP::updateFocalList()
 {
 	auto open_head = open_list.top();
 	if (open_head->getFVal() > min_f_val)
 	{
 		int new_min_f_val = (int)open_head->getFVal();
-		for (auto n : open_list)
+		// only the buckets of these f-vals are visited by bucket queues
+		open_list.visit((int)(w * min_f_val) + 1, (int)(w * new_min_f_val), [&](SIPPNode* n)
 		{
 			if (n->getFVal() > w * min_f_val && n->getFVal() <= w * new_min_f_val)
-				n->focal_handle = focal_list.push(n);
-		}
+				focal_list.push(n);
+		});
 		min_f_val = new_min_f_val;
 	}
 }
@@ -369,61 +450,64 @@ void SIPP::updateFocalList()
 inline void SIPP::pushNodeToOpenAndFocal(SIPPNode* node)
 {
     num_generated++;
-	node->open_handle = open_list.push(node);
+	open_list.push(node);
 	node->in_openlist = true;
 	if (node->getFVal() <= w * min_f_val)
-		node->focal_handle = focal_list.push(node);
-    allNodes_table[node].push_back(node);
+		focal_list.push(node);
+    insertNodeToTable(node);
 }
 inline void SIPP::pushNodeToFocal(SIPPNode* node)
 {
     num_generated++;
-    allNodes_table[node].push_back(node);
+    insertNodeToTable(node);
     node->in_openlist = true;
-    node->focal_handle = focal_list.push(node); // we only use focal list; no open list is used
+    focal_list.push(node); // we only use focal list; no open list is used
+}
+inline void SIPP::insertNodeToTable(SIPPNode* node)
+{
+    node->next_equal = nullptr;
+    auto* last = &allNodes_table[node];
+    while (*last != nullptr)
+        last = &(*last)->next_equal;
+    *last = node;
 }
 inline void SIPP::eraseNodeFromLists(SIPPNode* node)
 {
     if (open_list.empty())
     { // we only have focal list
-        focal_list.erase(node->focal_handle);
+        focal_list.erase(node);
     }
     else if (focal_list.empty())
     {  // we only have open list
-        open_list.erase(node->open_handle);
+        open_list.erase(node);
     }
     else
     { // we have both open and focal
-        open_list.erase(node->open_handle);
+        open_list.erase(node);
         if (node->getFVal() <= w * min_f_val)
-            focal_list.erase(node->focal_handle);
+            focal_list.erase(node);
     }
 }
 void SIPP::releaseNodes()
 {
     open_list.clear();
     focal_list.clear();
-    for (auto & node_list : allNodes_table)
-        for (auto n : node_list.second)
-            delete n;
     allNodes_table.clear();
-    for (auto n : useless_nodes)
-        delete n;
-    useless_nodes.clear();
+    node_arena.reset();
 }
 
 void SIPP::printSearchTree() const
 {
     vector<list<SIPPNode*>> nodes;
-    for (const auto & node_list : allNodes_table)
+    allNodes_table.visit([&](SIPPNode* first)
     {
-        for (const auto & n : node_list.second)
+        for (auto n = first; n != nullptr; n = n->next_equal)
         {
             if (nodes.size() <= n->timestep)
                 nodes.resize(n->timestep + 1);
             nodes[n->timestep].emplace_back(n);
         }
-    }
+    });
     cout << "Search Tree" << endl;
     for(int t = 0; t < nodes.size(); t++)
     {
@@ -437,10 +521,8 @@ void SIPP::printSearchTree() const
 // return true iff we the new node is not dominated by any old node
 bool SIPP::dominanceCheck(SIPPNode* new_node)
 {
-    auto ptr = allNodes_table.find(new_node);
-    if (ptr == allNodes_table.end())
-        return true;
-    for (auto & old_node : ptr->second)
+    auto link = &allNodes_table[new_node]; // the pointer to old_node
+    for (auto old_node = *link; old_node != nullptr; link = &old_node->next_equal, old_node = *link)
     {
         if (old_node->timestep <= new_node->timestep and
             old_node->num_of_conflicts <= new_node->num_of_conflicts)
@@ -454,8 +536,8 @@ bool SIPP::dominanceCheck(SIPPNode* new_node)
                 eraseNodeFromLists(old_node); // delete it from open and/or focal lists
             else // the old node has been expanded already
                 num_reopened++; //re-expand it
-            useless_nodes.push_back(old_node);
-            ptr->second.remove(old_node);
+            // the old node stays in the node arena until the search ends, as it can be the parent of other nodes
+            *link = old_node->next_equal;
             num_generated--; // this is because we later will increase num_generated when we insert the new node into lists.
             return true;
         }
@@ -1,5 +1,8 @@
 #include "SpaceTimeAStar.h"
 
+thread_local NodeArena<AStarNode> SpaceTimeAStar::node_arena;
+thread_local SpaceTimeAStar::hashtable_t SpaceTimeAStar::allNodes_table;
+
 
 void SpaceTimeAStar::updatePath(const LLNode* goal, vector<PathEntry> &path)
 {
@@ -38,11 +41,11 @@ Path SpaceTimeAStar::findPath(const ConstraintTable& constraint_table)
     auto last_target_collision_time = constraint_table.getLastCollisionTimestep(goal_location);
     // generate start and add it to the OPEN & FOCAL list
     auto h = max(max(my_heuristic[start_location], holding_time), last_target_collision_time + 1);
-    auto start = new AStarNode(start_location, 0, h, nullptr, 0, 0);
+    auto start = createNode(start_location, 0, h, nullptr, 0, 0);
     num_generated++;
     start->in_openlist = true;
-    start->focal_handle = focal_list.push(start); // we only use focal list; no open list is used
-    allNodes_table.insert(start);
+    focal_list.push(start); // we only use focal list; no open list is used
+    allNodes_table[start] = start;
     while (!focal_list.empty())
     {
         auto* curr = focal_list.top();
@@ -67,40 +70,39 @@ Path SpaceTimeAStar::findPath(const ConstraintTable& constraint_table)
                 break;
             }
             // generate a goal node
-            auto goal = new AStarNode(*curr);
+            auto goal = createNode(*curr);
             goal->is_goal = true;
             goal->parent = curr;
             goal->num_of_conflicts += future_collisions;
             goal->h_val = 0;
             // try to retrieve it from the hash table
-            auto it = allNodes_table.find(goal);
-            if (it == allNodes_table.end())
+            auto& stored_node = allNodes_table[goal];
+            if (stored_node == nullptr)
             {
-                goal->focal_handle = focal_list.push(goal);
+                stored_node = goal;
+                focal_list.push(goal);
                 goal->in_openlist = true;
                 num_generated++;
-                allNodes_table.insert(goal);
             }
             else // update existing node's if needed (only in the open_list)
             {
-                auto existing_next = *it;
+                auto existing_next = stored_node;
                 if (existing_next->num_of_conflicts > goal->num_of_conflicts ||
                    (existing_next->num_of_conflicts == goal->num_of_conflicts &&
                     existing_next->getFVal() > goal->getFVal()))
                 {
                     assert(existing_next->in_openlist);
                     existing_next->copy(*goal);	// update existing node
-                    focal_list.update(existing_next->focal_handle);
+                    focal_list.update(existing_next);
                     num_generated++; // reopen is considered as a new node
                 }
-                delete (goal);
+                node_arena.release(goal);
             }
         }
         if (curr->timestep >= constraint_table.length_max)
             continue;
 
-        auto next_locations = instance.getNeighbors(curr->location);
-        next_locations.emplace_back(curr->location);
+        auto next_locations = instance.getNextLocations(curr->location);
         for (int next_location : next_locations)
         {
             int next_timestep = curr->timestep + 1;
@@ -129,25 +131,25 @@ Path SpaceTimeAStar::findPath(const ConstraintTable& constraint_table)
             else
                 next_h_val = max(next_h_val, holding_time - next_g_val); // path max
             // generate (maybe temporary) node
-            auto next = new AStarNode(next_location, next_g_val, next_h_val,
+            auto next = createNode(next_location, next_g_val, next_h_val,
                                       curr, next_timestep, num_conflicts);
 
             if (next_location == goal_location && curr->location == goal_location)
                 next->wait_at_goal = true;
 
             // try to retrieve it from the hash table
-            auto it = allNodes_table.find(next);
-            if (it == allNodes_table.end())
+            auto& stored_node = allNodes_table[next];
+            if (stored_node == nullptr)
             {
-                next->focal_handle = focal_list.push(next);
+                stored_node = next;
+                focal_list.push(next);
                 next->in_openlist = true;
                 num_generated++;
-                allNodes_table.insert(next);
                 continue;
             }
             // update existing node's if needed (only in the open_list)
 
-            auto existing_next = *it;
+            auto existing_next = stored_node;
             if (existing_next->num_of_conflicts > next->num_of_conflicts  ||
                 (existing_next->num_of_conflicts == next->num_of_conflicts &&
                 existing_next->getFVal() > next->getFVal()))
@@ -155,18 +157,18 @@ Path SpaceTimeAStar::findPath(const ConstraintTable& constraint_table)
                 if (!existing_next->in_openlist) // if its in the closed list (reopen)
                 {
                     existing_next->copy(*next);
-                    existing_next->focal_handle = focal_list.push(existing_next);
+                    focal_list.push(existing_next);
                     existing_next->in_openlist = true;
                     num_generated++; // reopen is considered as a new node
                 }
                 else
                 {
                     existing_next->copy(*next);	// update existing node
-                    focal_list.update(existing_next->focal_handle);
+                    focal_list.update(existing_next);
                 }
             }
 
-            delete(next);  // not needed anymore -- we already generated it before
+            node_arena.release(next);  // not needed anymore -- we already generated it before
         }  // end for loop that generates successors
     }  // end while loop
 
@@ -205,13 +207,13 @@ pair<Path, int> SpaceTimeAStar::findSuboptimalPath(const HLNode& node, const Con
     lowerbound =  max(holding_time, lowerbound);
 
 	// generate start and add it to the OPEN & FOCAL list
-	auto start = new AStarNode(start_location, 0, max(lowerbound, my_heuristic[start_location]), nullptr, 0, 0);
+	auto start = createNode(start_location, 0, max(lowerbound, my_heuristic[start_location]), nullptr, 0, 0);
 
 	num_generated++;
-	start->open_handle = open_list.push(start);
-	start->focal_handle = focal_list.push(start);
+	open_list.push(start);
+	focal_list.push(start);
 	start->in_openlist = true;
-	allNodes_table.insert(start);
+	allNodes_table[start] = start;
 	min_f_val = (int) start->getFVal();
 	// lower_bound = int(w * min_f_val));
 
@@ -232,8 +234,7 @@ pair<Path, int> SpaceTimeAStar::findSuboptimalPath(const HLNode& node, const Con
 		if (curr->timestep >= constraint_table.length_max)
 			continue;
 
-		auto next_locations = instance.getNeighbors(curr->location);
-		next_locations.emplace_back(curr->location);
+		auto next_locations = instance.getNextLocations(curr->location);
 		for (int next_location : next_locations)
 		{
 			int next_timestep = curr->timestep + 1;
@@ -259,22 +260,22 @@ pair<Path, int> SpaceTimeAStar::findSuboptimalPath(const HLNode& node, const Con
 				constraint_table.getNumOfConflictsForStep(curr->location, next_location, next_timestep);
 
 			// generate (maybe temporary) node
-			auto next = new AStarNode(next_location, next_g_val, next_h_val,
+			auto next = createNode(next_location, next_g_val, next_h_val,
 				curr, next_timestep, next_internal_conflicts);
 			if (next_location == goal_location && curr->location == goal_location)
 				next->wait_at_goal = true;
 
 			// try to retrieve it from the hash table
-			auto it = allNodes_table.find(next);
-			if (it == allNodes_table.end())
+			auto& stored_node = allNodes_table[next];
+			if (stored_node == nullptr)
 			{
+				stored_node = next;
 				pushNode(next);
-				allNodes_table.insert(next);
 				continue;
 			}
 			// update existing node's if needed (only in the open_list)
 
-			auto existing_next = *it;
+			auto existing_next = stored_node;
 			if (existing_next->getFVal() > next->getFVal() || // if f-val decreased through this new path
 				(existing_next->getFVal() == next->getFVal() &&
 					existing_next->num_of_conflicts > next->num_of_conflicts)) // or it remains the same but there's fewer conflicts
@@ -302,15 +303,15 @@ pair<Path, int> SpaceTimeAStar::findSuboptimalPath(const HLNode& node, const Con
 					existing_next->copy(*next);	// update existing node
 
 					if (update_open)
-						open_list.increase(existing_next->open_handle);  // increase because f-val improved
+						open_list.increase(existing_next);  // increase because f-val improved
 					if (add_to_focal)
-						existing_next->focal_handle = focal_list.push(existing_next);
+						focal_list.push(existing_next);
 					if (update_in_focal)
-						focal_list.update(existing_next->focal_handle);  // should we do update? yes, because number of conflicts may go up or down			
+						focal_list.update(existing_next);  // should we do update? yes, because number of conflicts may go up or down			
 				}
 			}
 
-			delete(next);  // not needed anymore -- we already generated it before
+			node_arena.release(next);  // not needed anymore -- we already generated it before
 		}  // end for loop that generates successors
 	}  // end while loop
 
@@ -324,9 +325,9 @@ int SpaceTimeAStar::getTravelTime(int start, int end, const ConstraintTable& con
     reset();
 	int length = MAX_TIMESTEP;
     auto static_timestep = constraint_table.getMaxTimestep() + 1; // everything is static after this timestep
-	auto root = new AStarNode(start, 0, compute_heuristic(start, end), nullptr, 0, 0);
-	root->open_handle = open_list.push(root);  // add root to heap
-	allNodes_table.insert(root);       // add root to hash_table (nodes)
+	auto root = createNode(start, 0, compute_heuristic(start, end), nullptr, 0, 0);
+	open_list.push(root);  // add root to heap
+	allNodes_table[root] = root;       // add root to hash_table (nodes)
 	AStarNode* curr = nullptr;
 	while (!open_list.empty())
 	{
@@ -336,8 +337,7 @@ int SpaceTimeAStar::getTravelTime(int start, int end, const ConstraintTable& con
 			length = curr->g_val;
 			break;
 		}
-		list<int> next_locations = instance.getNeighbors(curr->location);
-		next_locations.emplace_back(curr->location);
+		auto next_locations = instance.getNextLocations(curr->location);
 		for (int next_location : next_locations)
 		{
 			int next_timestep = curr->timestep + 1;
@@ -356,21 +356,21 @@ int SpaceTimeAStar::getTravelTime(int start, int end, const ConstraintTable& con
 				int next_h_val = compute_heuristic(next_location, end);
 				if (next_g_val + next_h_val >= upper_bound) // the cost of the path is larger than the upper bound
 					continue;
-				auto next = new AStarNode(next_location, next_g_val, next_h_val, nullptr, next_timestep, 0);
-				auto it = allNodes_table.find(next);
-				if (it == allNodes_table.end())
+				auto next = createNode(next_location, next_g_val, next_h_val, nullptr, next_timestep, 0);
+				auto& stored_node = allNodes_table[next];
+				if (stored_node == nullptr)
 				{  // add the newly generated node to heap and hash table
-					next->open_handle = open_list.push(next);
-					allNodes_table.insert(next);
+					stored_node = next;
+					open_list.push(next);
 				}
 				else {  // update existing node's g_val if needed (only in the heap)
-					delete(next);  // not needed anymore -- we already generated it before
-					auto existing_next = *it;
+					node_arena.release(next);  // not needed anymore -- we already generated it before
+					auto existing_next = stored_node;
 					if (existing_next->g_val > next_g_val)
 					{
 						existing_next->g_val = next_g_val;
 						existing_next->timestep = next_timestep;
-						open_list.increase(existing_next->open_handle);
+						open_list.increase(existing_next);
 					}
 				}
 			}
@@ -386,7 +386,7 @@ int SpaceTimeAStar::getTravelTime(int start, int end, const ConstraintTable& con
 inline AStarNode* SpaceTimeAStar::popNode()
 {
 	auto node = focal_list.top(); focal_list.pop();
-	open_list.erase(node->open_handle);
+	open_list.erase(node);
 	node->in_openlist = false;
 	num_expanded++;
 	return node;
@@ -395,11 +395,11 @@ inline AStarNode* SpaceTimeAStar::popNode()
 
 inline void SpaceTimeAStar::pushNode(AStarNode* node)
 {
-	node->open_handle = open_list.push(node);
+	open_list.push(node);
 	node->in_openlist = true;
 	num_generated++;
 	if (node->getFVal() <= w * min_f_val)
-		node->focal_handle = focal_list.push(node);		
+		focal_list.push(node);		
 }
 
 
@@ -409,11 +409,12 @@ void SpaceTimeAStar::updateFocalList()
 	if (open_head->getFVal() > min_f_val)
 	{
 		int new_min_f_val = (int)open_head->getFVal();
-		for (auto n : open_list)
+		// only the buckets of these f-vals are visited by bucket queues
+		open_list.visit((int)(w * min_f_val) + 1, (int)(w * new_min_f_val), [&](AStarNode* n)
 		{
-			if (n->getFVal() >  w * min_f_val && n->getFVal() <= w * new_min_f_val)
-				n->focal_handle = focal_list.push(n);
-		}
+			if (n->getFVal() > w * min_f_val && n->getFVal() <= w * new_min_f_val)
+				focal_list.push(n);
+		});
 		min_f_val = new_min_f_val;
 	}
 }
@@ -423,8 +424,7 @@ void SpaceTimeAStar::releaseNodes()
 {
 	open_list.clear();
 	focal_list.clear();
-	for (auto node: allNodes_table)
-		delete node;
 	allNodes_table.clear();
+	node_arena.reset();
 }
 
@@ -16,8 +16,9 @@ int main(int argc, char** argv)
 		("help", "produce help message")
 
 		// params for the input instance and experiment settings
-		("map,m", po::value<string>()->required(), "input file for map")
-		("agents,a", po::value<string>()->required(), "input file for agents")
+		("map,m", po::value<string>(), "input file for map")
+		("agents,a", po::value<string>(), "input file for agents")
+		("bundle,b", po::value<string>(), "input bundle made by mapf-pack (instead of the map and agent files)")
 		("agentNum,k", po::value<int>()->default_value(0), "number of agents")
         ("output,o", po::value<string>(), "output file name (no extension)")
         ("outputPaths", po::value<string>(), "output file for paths")
@@ -30,6 +31,21 @@ int main(int argc, char** argv)
 		("solver", po::value<string>()->default_value("LNS"), "solver (LNS, A-BCBS, A-EECBS)")
 		("sipp", po::value<bool>()->default_value(true), "Use SIPP as the single-agent solver")
 		("seed", po::value<int>()->default_value(0), "Random seed")
+		("threads", po::value<int>()->default_value(1), "number of threads for computing the heuristics")
+		("landmarks", po::value<int>()->default_value(0),
+		        "number of shared landmarks for the ALT heuristic (0: exact heuristic tables for all agents)")
+		("hotSearches", po::value<int>()->default_value(10),
+		        "number of searches after which an agent switches from the ALT heuristic to its exact heuristic table")
+		("lazyHeuristics", po::value<bool>()->default_value(false),
+		        "compute the heuristics on demand by reverse resumable A* instead of precomputing full tables")
+		("heuristicWidth", po::value<int>()->default_value(32),
+		        "bits per location of the heuristic tables (32, 16, or 2 for delta encoding)")
+		("heuristicCache", po::value<bool>()->default_value(false),
+		        "load/save the goal heuristic tables from/to a cache file next to the map")
+		("lowLevelQueue", po::value<string>()->default_value("heap"),
+		        "OPEN and FOCAL of the single-agent solvers (heap: pairing heaps, bucket: integer bucket queues)")
+		("pathTableLayout", po::value<string>()->default_value("location"),
+		        "storage of the collision-free path tables (location: location-major, time: time-major chunks of all locations, i.e., 4 bytes per location and timestep up to the makespan, sparse: runs of timesteps per location)")
 
         // params for LNS
         ("initLNS", po::value<bool>()->default_value(true),
@@ -46,6 +62,8 @@ int main(int argc, char** argv)
              "window size for winPIBT")
         ("winPibtSoftmode", po::value<bool>()->default_value(true),
              "winPIBT soft mode")
+        ("pibtDistBudget", po::value<int>()->default_value(1024),
+             "memory budget (MB) of the goal distance tables used by PIBT, winPIBT and PPS")
 
          // params for initLNS
          ("initDestoryStrategy", po::value<string>()->default_value("Adaptive"),
@@ -62,16 +80,55 @@ int main(int argc, char** argv)
     PIBTPPS_option pipp_option;
     pipp_option.windowSize = vm["pibtWindow"].as<int>();
     pipp_option.winPIBTSoft = vm["winPibtSoftmode"].as<bool>();
+    pipp_option.distBudgetMB = vm["pibtDistBudget"].as<int>();
 
     po::notify(vm);
 
 	srand((int)time(0));
 
-	Instance instance(vm["map"].as<string>(), vm["agents"].as<string>(),
-		vm["agentNum"].as<int>());
+	if (!vm.count("bundle") && (!vm.count("map") || !vm.count("agents")))
+	{
+		cerr << "Either the map and agent files or a bundle are required" << endl;
+		return -1;
+	}
+	std::unique_ptr<Instance> instance_ptr(vm.count("bundle") ?
+		new Instance(vm["bundle"].as<string>(), vm["agentNum"].as<int>()) :
+		new Instance(vm["map"].as<string>(), vm["agents"].as<string>(), vm["agentNum"].as<int>()));
+	const Instance& instance = *instance_ptr;
     double time_limit = vm["cutoffTime"].as<double>();
     int screen = vm["screen"].as<int>();
 	srand(vm["seed"].as<int>());
+	SingleAgentSolver::setSeed(vm["seed"].as<int>());
+	HeuristicStore::setLandmarks(vm["landmarks"].as<int>(), vm["hotSearches"].as<int>());
+	HeuristicStore::setLazy(vm["lazyHeuristics"].as<bool>());
+	switch (vm["heuristicWidth"].as<int>())
+	{
+		case 32: HeuristicStore::setWidth(DistanceTable::INT32); break;
+		case 16: HeuristicStore::setWidth(DistanceTable::UINT16); break;
+		case 2: HeuristicStore::setWidth(DistanceTable::DELTA2); break;
+		default:
+			cerr << "Heuristic width " << vm["heuristicWidth"].as<int>() << " does not exist!" << endl;
+			exit(-1);
+	}
+	if (vm["lowLevelQueue"].as<string>() == "bucket")
+		SingleAgentSolver::setBucketQueues(true);
+	else if (vm["lowLevelQueue"].as<string>() != "heap")
+	{
+		cerr << "Low-level queue " << vm["lowLevelQueue"].as<string>() << " does not exist!" << endl;
+		exit(-1);
+	}
+	if (vm["pathTableLayout"].as<string>() == "time")
+		PathTable::setLayout(PathTable::TIME_MAJOR);
+	else if (vm["pathTableLayout"].as<string>() == "sparse")
+		PathTable::setLayout(PathTable::SPARSE);
+	else if (vm["pathTableLayout"].as<string>() != "location")
+	{
+		cerr << "Path table layout " << vm["pathTableLayout"].as<string>() << " does not exist!" << endl;
+		exit(-1);
+	}
+	HeuristicStore::useBundledHeuristics(instance);
+	if (vm["heuristicCache"].as<bool>())
+		HeuristicStore::useCacheFile(instance);
 
 	if (vm["solver"].as<string>() == "LNS")
     {
@@ -84,7 +141,8 @@ int main(int argc, char** argv)
                 vm["initLNS"].as<bool>(),
                 vm["initDestoryStrategy"].as<string>(),
                 vm["sipp"].as<bool>(),
-                screen, pipp_option);
+                screen, pipp_option, vm["threads"].as<int>());
+        HeuristicStore::saveCacheFile();
         bool succ = lns.run();
         if (succ)
         {
@@ -125,6 +183,7 @@ int main(int argc, char** argv)
 	    cerr << "Solver " << vm["solver"].as<string>() << " does not exist!" << endl;
 	    exit(-1);
     }
+	HeuristicStore::saveCacheFile(); // the anytime solvers build their search engines while running
 	return 0;
 
 }
\ No newline at end of file
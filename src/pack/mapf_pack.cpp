@@ -0,0 +1,37 @@
+#include <boost/program_options.hpp>
+#include "Instance.h"
+
+
+/* Convert a map and a scenario into a binary bundle that mapf --bundle loads without parsing */
+int main(int argc, char** argv)
+{
+	namespace po = boost::program_options;
+	// Declare the supported options.
+	po::options_description desc("Allowed options");
+	desc.add_options()
+		("help", "produce help message")
+		("map,m", po::value<string>()->required(), "input file for map")
+		("agents,a", po::value<string>()->required(), "input file for agents")
+		("agentNum,k", po::value<int>()->default_value(0), "number of agents")
+		("output,o", po::value<string>()->required(), "output bundle file")
+		("heuristics", po::value<bool>()->default_value(true),
+		        "store the heuristic tables of all goal locations in the bundle")
+		;
+	po::variables_map vm;
+	po::store(po::parse_command_line(argc, argv, desc), vm);
+
+	if (vm.count("help")) {
+		cout << desc << endl;
+		return 1;
+	}
+	po::notify(vm);
+
+	Instance instance(vm["map"].as<string>(), vm["agents"].as<string>(),
+		vm["agentNum"].as<int>());
+	auto start_time = Time::now();
+	if (!instance.saveBundle(vm["output"].as<string>(), vm["heuristics"].as<bool>()))
+		return -1;
+	cout << "Saved " << instance.getDefaultNumberOfAgents() << " agents to " << vm["output"].as<string>()
+	     << " in " << ((fsec)(Time::now() - start_time)).count() << " seconds" << endl;
+	return 0;
+}